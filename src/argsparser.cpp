@@ -4,6 +4,7 @@
 #include <tuning/nnuetrainer.hpp>
 #include <tuning/datamerger.hpp>
 #include <tests/test.hpp>
+#include <nnue.hpp>
 
 using namespace Arcanum;
 
@@ -34,6 +35,10 @@ bool ArgsParser::parseArgumentsAndRunCommand(int argc, char* argv[])
     {
         return parseArgumentsAndMergeData(argc, argv);
     }
+    else if(command == "quantize")
+    {
+        return parseArgumentsAndQuantizeNet(argc, argv);
+    }
 
     INFO("Unknown command: " << command)
 
@@ -56,6 +61,7 @@ bool ArgsParser::parseArgumentsAndRunFengen(int argc, char* argv[])
         if(matchAndParseArg("--numthreads",     params.numThreads,     argc, argv, index)) { continue; }
         if(matchAndParseArg("--depth",          params.depth,          argc, argv, index)) { continue; }
         if(matchAndParseArg("--movetime",       params.movetime,       argc, argv, index)) { continue; }
+        if(matchAndParseArg("--softtime",       params.softtime,       argc, argv, index)) { continue; }
         if(matchAndParseArg("--nodes",          params.nodes,          argc, argv, index)) { continue; }
         if(matchAndParseArg("--offset",         params.offset,         argc, argv, index)) { continue; }
         if(matchAndParseArg("--scorelimit",     params.scoreLimit,     argc, argv, index)) { continue; }
@@ -83,6 +89,9 @@ bool ArgsParser::parseArgumentsAndRunFengen(int argc, char* argv[])
     if(params.depth == 0 && params.movetime == 0 && params.nodes == 0)
     { valid = false; INFO("Search depth, movetime and nodes cannot be 0 at the same time") }
 
+    if(params.softtime > params.movetime)
+    { valid = false; INFO("Softtime cannot be larger than movetime, as movetime is used as the hard time limit") }
+
     if(valid)
     {
         INFO("Starting fengen with parameters:")
@@ -95,6 +104,7 @@ bool ArgsParser::parseArgumentsAndRunFengen(int argc, char* argv[])
         INFO("Num threads:       " << params.numThreads)
         INFO("Depth:             " << params.depth)
         INFO("Movetime (ms):     " << params.movetime)
+        INFO("Softtime (ms):     " << params.softtime)
         INFO("Nodes:             " << params.nodes)
 
         Fengen::start(params);
@@ -205,4 +215,34 @@ bool ArgsParser::parseArgumentsAndMergeData(int argc, char* argv[])
     }
 
     return merger.mergeData();
+}
+
+bool ArgsParser::parseArgumentsAndQuantizeNet(int argc, char* argv[])
+{
+    std::string input = "";
+    std::string output = "";
+
+    int index = 2; // Skip the executable name and command
+    while(index < argc)
+    {
+        if(matchAndParseArg("--input",  input,  argc, argv, index)) { continue; }
+        if(matchAndParseArg("--output", output, argc, argv, index)) { continue; }
+
+        INFO("Unknown argument: " << argv[index])
+        return false;
+    }
+
+    if(input == "" || output == "")
+    {
+        INFO("Both the input and output path of the net have to be set")
+        return false;
+    }
+
+    NNUE nnue;
+    if(!nnue.load(input))
+    {
+        return false;
+    }
+
+    return nnue.storeQuantized(output);
 }
\ No newline at end of file
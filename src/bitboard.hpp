@@ -121,6 +121,13 @@ namespace Arcanum
         return BitboardLookups::betweens[from][to];
     }
 
+    // Returns a bitboard with the full line through 'from' and 'to', from edge to edge
+    // If 'from' and 'to' are not on the same rank, file or diagonal, 0 is returned
+    static inline bitboard_t getLine(const square_t from, const square_t to)
+    {
+        return BitboardLookups::lines[from][to];
+    }
+
     static std::string squareToString(square_t square)
     {
         std::string str = "a1";
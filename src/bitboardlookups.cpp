@@ -5,6 +5,7 @@
 using namespace Arcanum;
 
 bitboard_t BitboardLookups::betweens[64][64];
+bitboard_t BitboardLookups::lines[64][64];
 bitboard_t BitboardLookups::knightMoves[64];
 bitboard_t BitboardLookups::kingMoves[64];
 #ifdef USE_BMI2
@@ -88,6 +89,38 @@ void generateBetweensLookups()
     }
 }
 
+void generateLinesLookups()
+{
+    for(square_t from = 0; from < 64; from++)
+    {
+        for(square_t to = 0; to < 64; to++)
+        {
+            BitboardLookups::lines[from][to] = 0LL;
+
+            // The line only exists if 'from' and 'to' are different squares on the same rank, file or diagonal
+            int8_t fileDiff = int8_t(FILE(to)) - int8_t(FILE(from));
+            int8_t rankDiff = int8_t(RANK(to)) - int8_t(RANK(from));
+            if((from == to) || (fileDiff != 0 && rankDiff != 0 && std::abs(fileDiff) != std::abs(rankDiff)))
+                continue;
+
+            // Walk from 'from' to the edge of the board in both directions
+            int8_t fileStep = (fileDiff > 0) - (fileDiff < 0);
+            int8_t rankStep = (rankDiff > 0) - (rankDiff < 0);
+            for(int8_t direction : {1, -1})
+            {
+                int8_t file = FILE(from);
+                int8_t rank = RANK(from);
+                while(file >= 0 && file < 8 && rank >= 0 && rank < 8)
+                {
+                    BitboardLookups::lines[from][to] |= SQUARE_BB(file, rank);
+                    file += direction * fileStep;
+                    rank += direction * rankStep;
+                }
+            }
+        }
+    }
+}
+
 void generateKnightLookups()
 {
     // Source: https://www.chessprogramming.org/Knight_Pattern
@@ -471,6 +504,7 @@ void generateBishopLookups()
 void Arcanum::BitboardLookups::generateBitboardLookups()
 {
     generateBetweensLookups();
+    generateLinesLookups();
     generateKnightLookups();
     generateKingLookups();
     generateRookLookups();
@@ -12,6 +12,7 @@ namespace Arcanum
     namespace BitboardLookups
     {
         extern bitboard_t betweens[64][64];
+        extern bitboard_t lines[64][64];
         extern bitboard_t knightMoves[64];
         extern bitboard_t kingMoves[64];
         #ifdef USE_BMI2
@@ -6,6 +6,11 @@
 
 using namespace Arcanum;
 
+// Squares which have to be empty, and squares which cannot be attacked, when castling
+// Indexed by CastleIndex
+static constexpr bitboard_t CastlePieceMasks[4]  = { 0x0ELL, 0x60LL, 0x0E00000000000000LL, 0x6000000000000000LL };
+static constexpr bitboard_t CastleAttackMasks[4] = { 0x0CLL, 0x60LL, 0x0C00000000000000LL, 0x6000000000000000LL };
+
 Board::Board()
 {
     m_hash = 0LL;
@@ -35,8 +40,6 @@ Board::Board()
         }
     }
 
-    m_moveset = MoveSet::NOT_GENERATED;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     m_blockersGenerated = MoveSet::NOT_GENERATED;
     m_bbOpponentAttacks = 0LL;
 }
@@ -84,8 +87,6 @@ Board::Board(const Board& board)
     m_bbTypedPieces[Piece::QUEEN][Color::BLACK]     = board.m_bbTypedPieces[Piece::QUEEN][Color::BLACK];
     m_bbTypedPieces[Piece::KING][Color::BLACK]      = board.m_bbTypedPieces[Piece::KING][Color::BLACK];
 
-    m_moveset = MoveSet::NOT_GENERATED; // Moves are not copied over
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     m_blockersGenerated = MoveSet::NOT_GENERATED;
     m_kingIdx = board.m_kingIdx;
     m_bbOpponentAttacks = board.m_bbOpponentAttacks;
@@ -120,8 +121,6 @@ inline void Board::m_findPinnedPieces()
 
             if(CNTSBITS(blockingSquares) == 1)
             {
-                square_t blockerIdx = LS1B(blockingSquares);
-                m_pinnerBlockerIdxPairs[c][blockerIdx] = sniperIdx;
                 m_blockers[c]  |= blockingSquares;
                 m_pinners[c^1] |= (1LL << sniperIdx);
             }
@@ -131,9 +130,9 @@ inline void Board::m_findPinnedPieces()
     m_blockersGenerated = MoveSet::ALL;
 }
 
-template <MoveInfoBit MoveType, Board::MoveSet Set>
+template <MoveInfoBit MoveType, Board::MoveSet Set, bool Legal>
 __attribute__((always_inline))
-inline void Board::m_generateMoves()
+inline void Board::m_generateMoves(MoveList& moves)
 {
     static_assert(MoveType != MoveInfoBit::PAWN_MOVE);
     static_assert(MoveType != MoveInfoBit::KING_MOVE);
@@ -164,10 +163,14 @@ inline void Board::m_generateMoves()
         }
 
         // Filter the allowed target squares
-        if constexpr (Set == MoveSet::CAPTURES)
+        if constexpr ((Set == MoveSet::CAPTURES) || (Set == MoveSet::NOISY))
         {
             targets &= m_bbColoredPieces[opponent]; // All opponent pieces
         }
+        else if constexpr (Set == MoveSet::QUIETS)
+        {
+            targets &= ~m_bbAllPieces; // All empty squares
+        }
         else if constexpr (Set == MoveSet::ALL)
         {
             targets &= ~m_bbColoredPieces[m_turn];  // All squares except own pieces
@@ -177,42 +180,75 @@ inline void Board::m_generateMoves()
         // Note: In theory, the blockers and non-blockers could be separated into
         // two loops, by using m_blockers[m_turn] as a mask. For some reason,
         // creating two loops seems to be a bit slower, so we continue to check if each piece is a blocker
-        if((1LL << pieceIdx) & m_blockers[m_turn])
+        if(Legal && ((1LL << pieceIdx) & m_blockers[m_turn]))
         {
-            square_t pinnerIdx = m_pinnerBlockerIdxPairs[m_turn][pieceIdx];
-            targets &= getBetweens(m_kingIdx, pinnerIdx);
+            targets &= getLine(m_kingIdx, pieceIdx);
         }
 
         while(targets)
         {
             square_t target = popLS1B(&targets);
-            m_legalMoves[m_numLegalMoves].from     = pieceIdx;
-            m_legalMoves[m_numLegalMoves].to       = target;
-            m_legalMoves[m_numLegalMoves].moveInfo = MoveType;
-            m_numLegalMoves++;
+            moves.add(Move(pieceIdx, target, MoveType));
         }
     }
 }
 
-template <Board::MoveSet Set>
+// Adds the selected promotions of a pawn move
+// If Legal is set, the promotions are only added if the move is legal
+template <bool Queen, bool UnderPromotions, bool Legal>
 __attribute__((always_inline))
-inline void Board::m_generatePawnMoves()
+inline void Board::m_addPromotions(MoveList& moves, square_t pawnIdx, square_t target)
+{
+    if constexpr(!Queen && !UnderPromotions)
+    {
+        return;
+    }
+
+    // If one promotion move is legal, all are legal
+    if(Legal && !m_isLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE)))
+    {
+        return;
+    }
+
+    if constexpr(Queen)
+    {
+        moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
+    }
+
+    if constexpr(UnderPromotions)
+    {
+        moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK));
+        moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP));
+        moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT));
+    }
+}
+
+template <Board::MoveSet Set, bool Legal>
+__attribute__((always_inline))
+inline void Board::m_generatePawnMoves(MoveList& moves)
 {
     constexpr bitboard_t PromotionSquares = 0xff000000000000ffLL;
+    constexpr bool GenerateCaptures = (Set != MoveSet::QUIETS);
+    constexpr bool GenerateQueenPromotions = (Set != MoveSet::QUIETS);
+    constexpr bool GenerateUnderPromotions = (Set == MoveSet::NOISY) || (Set == MoveSet::ALL);
+    constexpr bool GeneratePushes = (Set == MoveSet::QUIETS) || (Set == MoveSet::ALL);
 
     Color opponent = Color(m_turn^1);
 
     bitboard_t pawns = m_bbTypedPieces[Piece::PAWN][m_turn];
     bitboard_t bbAttacks, bbOrigins;
 
-    // Left attacks without promotion
-    bbAttacks = getPawnAttacksLeft(pawns, m_turn) & m_bbColoredPieces[opponent] & ~PromotionSquares;
-    bbOrigins = getPawnAttacksRight(bbAttacks, opponent);
-    while (bbAttacks)
+    if constexpr(GenerateCaptures)
     {
-        square_t target = popLS1B(&bbAttacks);
-        square_t pawnIdx = popLS1B(&bbOrigins);
-        m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+        // Left attacks without promotion
+        bbAttacks = getPawnAttacksLeft(pawns, m_turn) & m_bbColoredPieces[opponent] & ~PromotionSquares;
+        bbOrigins = getPawnAttacksRight(bbAttacks, opponent);
+        while (bbAttacks)
+        {
+            square_t target = popLS1B(&bbAttacks);
+            square_t pawnIdx = popLS1B(&bbOrigins);
+            m_attemptAddPseudoLegalMove<Legal>(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+        }
     }
 
     // Left attacks with promotion
@@ -222,24 +258,20 @@ inline void Board::m_generatePawnMoves()
     {
         square_t target = popLS1B(&bbAttacks);
         square_t pawnIdx = popLS1B(&bbOrigins);
-        // If one promotion move is legal, all are legal
-        bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
-        if(added && (Set == MoveSet::ALL))
-        {
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
-        }
+        m_addPromotions<GenerateQueenPromotions, GenerateUnderPromotions, Legal>(moves, pawnIdx, target);
     }
 
-    // Right attacks without promotion
-    bbAttacks = getPawnAttacksRight(pawns, m_turn) & m_bbColoredPieces[opponent] & ~PromotionSquares;
-    bbOrigins = getPawnAttacksLeft(bbAttacks, opponent);
-    while (bbAttacks)
+    if constexpr(GenerateCaptures)
     {
-        square_t target = popLS1B(&bbAttacks);
-        square_t pawnIdx = popLS1B(&bbOrigins);
-        m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+        // Right attacks without promotion
+        bbAttacks = getPawnAttacksRight(pawns, m_turn) & m_bbColoredPieces[opponent] & ~PromotionSquares;
+        bbOrigins = getPawnAttacksLeft(bbAttacks, opponent);
+        while (bbAttacks)
+        {
+            square_t target = popLS1B(&bbAttacks);
+            square_t pawnIdx = popLS1B(&bbOrigins);
+            m_attemptAddPseudoLegalMove<Legal>(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+        }
     }
 
     // Right attacks with promotions
@@ -249,24 +281,17 @@ inline void Board::m_generatePawnMoves()
     {
         square_t target = popLS1B(&bbAttacks);
         square_t pawnIdx = popLS1B(&bbOrigins);
-        // If one promotion move is legal, all are legal
-        bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
-        if(added && (Set == MoveSet::ALL))
-        {
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
-        }
+        m_addPromotions<GenerateQueenPromotions, GenerateUnderPromotions, Legal>(moves, pawnIdx, target);
     }
 
     // Enpassant
-    if(m_bbEnPassantSquare)
+    if(GenerateCaptures && m_bbEnPassantSquare)
     {
         bitboard_t enpassantAttackers = getPawnAttacks(m_bbEnPassantSquare, opponent) & pawns;
         while (enpassantAttackers)
         {
             square_t pawnIdx = popLS1B(&enpassantAttackers);
-            m_attemptAddPseudoLegalEnpassant(Move(pawnIdx, m_enPassantSquare, MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::ENPASSANT | MoveInfoBit::PAWN_MOVE));
+            m_attemptAddPseudoLegalEnpassant<Legal>(moves, Move(pawnIdx, m_enPassantSquare, MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::ENPASSANT | MoveInfoBit::PAWN_MOVE));
         }
     }
 
@@ -277,18 +302,10 @@ inline void Board::m_generatePawnMoves()
     {
         square_t target = popLS1B(&pawnMoves);
         square_t pawnIdx = popLS1B(&pawnMovesOrigin);
-
-        // If one promotion move is legal, all are legal
-        bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
-        if(added && (Set == MoveSet::ALL))
-        {
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-            m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
-        }
+        m_addPromotions<GenerateQueenPromotions, GenerateUnderPromotions, Legal>(moves, pawnIdx, target);
     }
 
-    if constexpr(Set == MoveSet::ALL)
+    if constexpr(GeneratePushes)
     {
         // Forward moves without promotion
         pawnMoves = getPawnMoves(pawns, m_turn) & ~m_bbAllPieces & ~PromotionSquares;
@@ -297,7 +314,7 @@ inline void Board::m_generatePawnMoves()
         {
             square_t target = popLS1B(&pawnMoves);
             square_t pawnIdx = popLS1B(&pawnMovesOrigin);
-            m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+            m_attemptAddPseudoLegalMove<Legal>(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
         }
 
         // Double move
@@ -307,7 +324,7 @@ inline void Board::m_generatePawnMoves()
         {
             int target = popLS1B(&doubleMoves);
             int pawnIdx = popLS1B(&doubleMovesOrigin);
-            m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::DOUBLE_MOVE | MoveInfoBit::PAWN_MOVE));
+            m_attemptAddPseudoLegalMove<Legal>(moves, Move(pawnIdx, target, MoveInfoBit::DOUBLE_MOVE | MoveInfoBit::PAWN_MOVE));
         }
     }
 }
@@ -350,8 +367,7 @@ inline bool Board::m_hasMove()
         // creating two loops seems to be a bit slower, so we continue to check if each piece is a blocker
         if((1LL << pieceIdx) & m_blockers[m_turn])
         {
-            square_t pinnerIdx = m_pinnerBlockerIdxPairs[m_turn][pieceIdx];
-            targets &= getBetweens(m_kingIdx, pinnerIdx);
+            targets &= getLine(m_kingIdx, pieceIdx);
         }
 
         if(targets)
@@ -363,6 +379,95 @@ inline bool Board::m_hasMove()
     return false;
 }
 
+// Counts the legal moves of the piece type without generating them
+// Shall only be used when not in check
+template <MoveInfoBit MoveType>
+inline uint8_t Board::m_countMoves() const
+{
+    static_assert(MoveType != MoveInfoBit::PAWN_MOVE);
+    static_assert(MoveType != MoveInfoBit::KING_MOVE);
+
+    Piece type;
+    switch (MoveType)
+    {
+        case MoveInfoBit::ROOK_MOVE:   type = Piece::ROOK;   break;
+        case MoveInfoBit::KNIGHT_MOVE: type = Piece::KNIGHT; break;
+        case MoveInfoBit::BISHOP_MOVE: type = Piece::BISHOP; break;
+        case MoveInfoBit::QUEEN_MOVE:  type = Piece::QUEEN;  break;
+    }
+
+    uint8_t count = 0;
+    bitboard_t pieces = m_bbTypedPieces[type][m_turn];
+    while (pieces)
+    {
+        square_t pieceIdx = popLS1B(&pieces);
+        bitboard_t targets;
+        switch (MoveType)
+        {
+            case MoveInfoBit::ROOK_MOVE:   targets = getRookMoves(m_bbAllPieces, pieceIdx);   break;
+            case MoveInfoBit::KNIGHT_MOVE: targets = getKnightMoves(pieceIdx);                break;
+            case MoveInfoBit::BISHOP_MOVE: targets = getBishopMoves(m_bbAllPieces, pieceIdx); break;
+            case MoveInfoBit::QUEEN_MOVE:  targets = getQueenMoves(m_bbAllPieces, pieceIdx);  break;
+        }
+
+        targets &= ~m_bbColoredPieces[m_turn];
+
+        // A pinned piece can only move along the pin
+        if((1LL << pieceIdx) & m_blockers[m_turn])
+        {
+            targets &= getLine(m_kingIdx, pieceIdx);
+        }
+
+        count += CNTSBITS(targets);
+    }
+
+    return count;
+}
+
+// Counts the legal pawn moves without generating them
+// Each promotion target counts as four moves
+// Shall only be used when not in check
+inline uint8_t Board::m_countPawnMoves() const
+{
+    constexpr bitboard_t PromotionSquares = 0xff000000000000ffLL;
+    Color opponent = Color(m_turn^1);
+
+    bitboard_t pawns = m_bbTypedPieces[Piece::PAWN][m_turn];
+    bitboard_t pinnedPawns = pawns & m_blockers[m_turn];
+    bitboard_t freePawns = pawns & ~pinnedPawns;
+
+    // The pawns which are not pinned are counted together
+    bitboard_t attacksLeft  = getPawnAttacksLeft(freePawns, m_turn) & m_bbColoredPieces[opponent];
+    bitboard_t attacksRight = getPawnAttacksRight(freePawns, m_turn) & m_bbColoredPieces[opponent];
+    bitboard_t pushes       = getPawnMoves(freePawns, m_turn) & ~m_bbAllPieces;
+    uint8_t count = CNTSBITS(attacksLeft) + CNTSBITS(attacksRight) + CNTSBITS(pushes)
+                  + 3 * CNTSBITS((attacksLeft | pushes) & PromotionSquares)
+                  + 3 * CNTSBITS(attacksRight & PromotionSquares)
+                  + CNTSBITS(getPawnDoubleMoves(freePawns, m_turn, m_bbAllPieces));
+
+    // Pinned pawns can only move along the pin
+    while (pinnedPawns)
+    {
+        square_t pawnIdx = popLS1B(&pinnedPawns);
+        bitboard_t bbPawn = (1LL << pawnIdx);
+        bitboard_t targets = (getPawnAttacks(bbPawn, m_turn) & m_bbColoredPieces[opponent])
+                           | (getPawnMoves(bbPawn, m_turn) & ~m_bbAllPieces)
+                           | getPawnDoubleMoves(bbPawn, m_turn, m_bbAllPieces);
+        targets &= getLine(m_kingIdx, pawnIdx);
+        count += CNTSBITS(targets) + 3 * CNTSBITS(targets & PromotionSquares);
+    }
+
+    // Enpassant
+    bitboard_t enpassantAttackers = getPawnAttacks(m_bbEnPassantSquare, opponent) & pawns;
+    while (enpassantAttackers)
+    {
+        square_t pawnIdx = popLS1B(&enpassantAttackers);
+        count += m_isLegalEnpassant(Move(pawnIdx, m_enPassantSquare, MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::ENPASSANT | MoveInfoBit::PAWN_MOVE));
+    }
+
+    return count;
+}
+
 inline bool Board::m_isLegalEnpassant(Move move) const
 {
     bitboard_t bbFrom = (0b1LL << move.from);
@@ -385,10 +490,8 @@ inline bool Board::m_isLegalEnpassant(Move move) const
         return true;
     }
 
-    // Checking that if a blocker is moved, the piece is still blocking.
-    // Have to check for blockers still blocking after move
-    square_t pinnerIdx = m_pinnerBlockerIdxPairs[m_turn][move.from];
-    if(getBetweens(m_kingIdx, pinnerIdx) & bbTo)
+    // A blocker which is moved has to stay on the line through the king
+    if(getLine(m_kingIdx, move.from) & bbTo)
     {
         return true;
     }
@@ -396,11 +499,12 @@ inline bool Board::m_isLegalEnpassant(Move move) const
     return false;
 }
 
-inline bool Board::m_attemptAddPseudoLegalEnpassant(Move move)
+template <bool Legal>
+inline bool Board::m_attemptAddPseudoLegalEnpassant(MoveList& moves, Move move)
 {
-    if(m_isLegalEnpassant(move))
+    if(!Legal || m_isLegalEnpassant(move))
     {
-        m_legalMoves[m_numLegalMoves++] = move;
+        moves.add(move);
         return true;
     }
 
@@ -417,10 +521,8 @@ inline bool Board::m_isLegalMove(Move move) const
         return true;
     }
 
-    // Checking that if a blocker is moved, the piece is still blocking.
-    // Have to check for blockers still blocking after move
-    square_t pinnerIdx = m_pinnerBlockerIdxPairs[m_turn][move.from];
-    if(getBetweens(m_kingIdx, pinnerIdx) & bbTo)
+    // A blocker which is moved has to stay on the line through the king
+    if(getLine(m_kingIdx, move.from) & bbTo)
     {
         return true;
     }
@@ -428,28 +530,21 @@ inline bool Board::m_isLegalMove(Move move) const
     return false;
 }
 
-inline bool Board::m_attemptAddPseudoLegalMove(Move move)
+template <bool Legal>
+inline bool Board::m_attemptAddPseudoLegalMove(MoveList& moves, Move move)
 {
-    if(m_isLegalMove(move))
+    if(!Legal || m_isLegalMove(move))
     {
-        m_legalMoves[m_numLegalMoves++] = move;
+        moves.add(move);
         return true;
     }
 
     return false;
 }
 
-Move* Board::getLegalMovesFromCheck()
+void Board::generateLegalMovesFromCheck(MoveList& moves)
 {
-    if(m_moveset == MoveSet::ALL)
-    {
-        return m_legalMoves;
-    }
-
-    m_moveset = MoveSet::ALL;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     m_findPinnedPieces();
-    m_numLegalMoves = 0;
     Color opponent = Color(m_turn^1);
     bitboard_t bbKing = m_bbTypedPieces[Piece::KING][m_turn];
 
@@ -481,14 +576,14 @@ Move* Board::getLegalMovesFromCheck()
     while(kMoves)
     {
         square_t target = popLS1B(&kMoves);
-        m_legalMoves[m_numLegalMoves++] = Move(m_kingIdx, target, MoveInfoBit::KING_MOVE);
+        moves.add(Move(m_kingIdx, target, MoveInfoBit::KING_MOVE));
     }
 
     // If there are more than one attacker, the only solution is to move the king
     // If there is only one attacker it is also possible to block or capture
     if(CNTSBITS(attackers) > 1)
     {
-        return m_legalMoves;
+        return;
     }
 
     // If the attacking piece is a pawn or knight, it is not possible to block
@@ -498,7 +593,7 @@ Move* Board::getLegalMovesFromCheck()
         // -- Knight captures
         bitboard_t capturingKnights = getKnightMoves(attackerIdx) & m_bbTypedPieces[Piece::KNIGHT][m_turn];
         while (capturingKnights)
-            m_attemptAddPseudoLegalMove(Move(popLS1B(&capturingKnights), attackerIdx, MoveInfoBit::KNIGHT_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(popLS1B(&capturingKnights), attackerIdx, MoveInfoBit::KNIGHT_MOVE));
 
         // -- Pawn captures
         bitboard_t capturingPawns = getPawnAttacks(attackers, opponent);
@@ -510,17 +605,17 @@ Move* Board::getLegalMovesFromCheck()
             if(attackers & 0xff000000000000ffLL)
             {
                 // If one promotion move is legal, all are legal
-                bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
+                bool added = m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
                 if(added)
                 {
-                    m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-                    m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-                    m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
+                    moves.add(Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK));
+                    moves.add(Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP));
+                    moves.add(Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT));
                 }
             }
             else
             {
-                m_attemptAddPseudoLegalMove(Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE));
+                m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, attackerIdx, MoveInfoBit::PAWN_MOVE));
             }
         }
 
@@ -530,7 +625,7 @@ Move* Board::getLegalMovesFromCheck()
         capturingPawns &= m_bbTypedPieces[Piece::PAWN][m_turn];
         while(capturingPawns)
         {
-            m_attemptAddPseudoLegalEnpassant(Move(popLS1B(&capturingPawns), m_enPassantSquare, MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::PAWN_MOVE | MoveInfoBit::ENPASSANT));
+            m_attemptAddPseudoLegalEnpassant(moves, Move(popLS1B(&capturingPawns), m_enPassantSquare, MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::PAWN_MOVE | MoveInfoBit::ENPASSANT));
         }
 
         // -- Rook + Queen captures
@@ -538,20 +633,20 @@ Move* Board::getLegalMovesFromCheck()
         bitboard_t capturingRooks = capturingRookMoves & m_bbTypedPieces[Piece::ROOK][m_turn];
         bitboard_t capturingRQueens = capturingRookMoves & m_bbTypedPieces[Piece::QUEEN][m_turn];
         while (capturingRooks)
-            m_attemptAddPseudoLegalMove(Move(popLS1B(&capturingRooks), attackerIdx, MoveInfoBit::ROOK_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(popLS1B(&capturingRooks), attackerIdx, MoveInfoBit::ROOK_MOVE));
         while (capturingRQueens)
-            m_attemptAddPseudoLegalMove(Move(popLS1B(&capturingRQueens), attackerIdx, MoveInfoBit::QUEEN_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(popLS1B(&capturingRQueens), attackerIdx, MoveInfoBit::QUEEN_MOVE));
 
         // -- Bishop + Queen captures
         bitboard_t capturingBishopMoves = getBishopMoves(m_bbAllPieces, attackerIdx);
         bitboard_t capturingBishops = capturingBishopMoves & m_bbTypedPieces[Piece::BISHOP][m_turn];
         bitboard_t capturingBQueens = capturingBishopMoves & m_bbTypedPieces[Piece::QUEEN][m_turn];
         while (capturingBishops)
-            m_attemptAddPseudoLegalMove(Move(popLS1B(&capturingBishops), attackerIdx, MoveInfoBit::BISHOP_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(popLS1B(&capturingBishops), attackerIdx, MoveInfoBit::BISHOP_MOVE));
         while (capturingBQueens)
-            m_attemptAddPseudoLegalMove(Move(popLS1B(&capturingBQueens), attackerIdx, MoveInfoBit::QUEEN_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(popLS1B(&capturingBQueens), attackerIdx, MoveInfoBit::QUEEN_MOVE));
 
-        return m_legalMoves;
+        return;
     }
 
     // -- The attacking piece is a sliding piece (Rook, Bishop or Queen)
@@ -572,7 +667,7 @@ Move* Board::getLegalMovesFromCheck()
         while(queenMoves)
         {
             square_t target = popLS1B(&queenMoves);
-            m_attemptAddPseudoLegalMove(Move(queenIdx, target, MoveInfoBit::QUEEN_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(queenIdx, target, MoveInfoBit::QUEEN_MOVE));
         }
     }
 
@@ -586,7 +681,7 @@ Move* Board::getLegalMovesFromCheck()
         while(knightMoves)
         {
             square_t target = popLS1B(&knightMoves);
-            m_attemptAddPseudoLegalMove(Move(knightIdx, target, MoveInfoBit::KNIGHT_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(knightIdx, target, MoveInfoBit::KNIGHT_MOVE));
         }
     }
 
@@ -601,7 +696,7 @@ Move* Board::getLegalMovesFromCheck()
         while(bishopMoves)
         {
             square_t target = popLS1B(&bishopMoves);
-            m_attemptAddPseudoLegalMove(Move(bishopIdx, target, MoveInfoBit::BISHOP_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(bishopIdx, target, MoveInfoBit::BISHOP_MOVE));
         }
     }
 
@@ -616,7 +711,7 @@ Move* Board::getLegalMovesFromCheck()
         while(rookMoves)
         {
             square_t target = popLS1B(&rookMoves);
-            m_attemptAddPseudoLegalMove(Move(rookIdx, target, MoveInfoBit::ROOK_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(rookIdx, target, MoveInfoBit::ROOK_MOVE));
         }
     }
 
@@ -643,19 +738,19 @@ Move* Board::getLegalMovesFromCheck()
         if((0b1LL << target) & 0xff000000000000ffLL)
         {
             // If one promotion move is legal, all are legal
-            bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
+            bool added = m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
             if(added)
             {
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT));
             }
         }
         else
         {
             // Note: The captured piece in enpassant cannot uncover a check, except if the king is on the side of both the attacking and captured pawn while there is a rook/queen in the same rank
             Move move = Move(pawnIdx, target, (target == m_enPassantSquare) ? (MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::ENPASSANT | MoveInfoBit::PAWN_MOVE) : MoveInfoBit::PAWN_MOVE);
-            m_attemptAddPseudoLegalEnpassant(move);
+            m_attemptAddPseudoLegalEnpassant(moves, move);
         }
     }
 
@@ -667,19 +762,19 @@ Move* Board::getLegalMovesFromCheck()
         if((0b1LL << target) & 0xff000000000000ffLL)
         {
             // If one promotion move is legal, all are legal
-            bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
+            bool added = m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
             if(added)
             {
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT));
             }
         }
         else
         {
             // Note: The captured piece in enpassant cannot uncover a check, except if the king is on the side of both the attacking and captured pawn while there is a rook/queen in the same rank
             Move move = Move(pawnIdx, target, (target == m_enPassantSquare) ? (MoveInfoBit::CAPTURE_PAWN | MoveInfoBit::ENPASSANT | MoveInfoBit::PAWN_MOVE) : MoveInfoBit::PAWN_MOVE);
-            m_attemptAddPseudoLegalEnpassant(move);
+            m_attemptAddPseudoLegalEnpassant(moves, move);
         }
     }
 
@@ -692,17 +787,17 @@ Move* Board::getLegalMovesFromCheck()
         if((0b1LL << target) & 0xff000000000000ffLL)
         {
             // If one promotion move is legal, all are legal
-            bool added = m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
+            bool added = m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_QUEEN));
             if(added)
             {
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP);
-                m_legalMoves[m_numLegalMoves++] = Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT);
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_ROOK));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_BISHOP));
+                moves.add(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE | MoveInfoBit::PROMOTE_KNIGHT));
             }
         }
         else
         {
-            m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
+            m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, target, MoveInfoBit::PAWN_MOVE));
         }
     }
 
@@ -713,55 +808,50 @@ Move* Board::getLegalMovesFromCheck()
     {
         int target = popLS1B(&doubleMoves);
         int pawnIdx = popLS1B(&doubleMovesOrigin);
-        m_attemptAddPseudoLegalMove(Move(pawnIdx, target, MoveInfoBit::DOUBLE_MOVE | MoveInfoBit::PAWN_MOVE));
+        m_attemptAddPseudoLegalMove(moves, Move(pawnIdx, target, MoveInfoBit::DOUBLE_MOVE | MoveInfoBit::PAWN_MOVE));
     }
-
-    return m_legalMoves;
 }
 
-Move* Board::getLegalMoves()
+// Generates the moves of the set when not in check
+// If Legal is not set, moves of pinned pieces are generated as well, and have to be checked with isLegal()
+// King moves and castling are always legal
+template <Board::MoveSet Set, bool Legal>
+inline void Board::m_generateMoveSet(MoveList& moves)
 {
-    // Safeguard against repeated calls to generate moves
-    if(m_moveset == MoveSet::ALL)
-    {
-        return m_legalMoves;
-    }
-
-    if(isChecked())
-    {
-        return getLegalMovesFromCheck();
-    }
-
-    m_moveset = MoveSet::ALL;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     m_findPinnedPieces();
-    m_numLegalMoves = 0;
 
-    m_generateMoves<MoveInfoBit::ROOK_MOVE, MoveSet::ALL>();
-    m_generateMoves<MoveInfoBit::KNIGHT_MOVE, MoveSet::ALL>();
-    m_generateMoves<MoveInfoBit::BISHOP_MOVE, MoveSet::ALL>();
-    m_generateMoves<MoveInfoBit::QUEEN_MOVE, MoveSet::ALL>();
-    m_generatePawnMoves<MoveSet::ALL>();
+    m_generateMoves<MoveInfoBit::ROOK_MOVE, Set, Legal>(moves);
+    m_generateMoves<MoveInfoBit::KNIGHT_MOVE, Set, Legal>(moves);
+    m_generateMoves<MoveInfoBit::BISHOP_MOVE, Set, Legal>(moves);
+    m_generateMoves<MoveInfoBit::QUEEN_MOVE, Set, Legal>(moves);
+    m_generatePawnMoves<Set, Legal>(moves);
 
     // King moves
     // Create bitboard for where the king would be attacked
     bitboard_t opponentAttacks = getOpponentAttacks();
     bitboard_t kMoves = getKingMoves(m_kingIdx);
     kMoves &= ~(m_bbColoredPieces[m_turn] | opponentAttacks);
+    if constexpr ((Set == MoveSet::CAPTURES) || (Set == MoveSet::NOISY))
+    {
+        kMoves &= m_bbColoredPieces[m_turn ^ 1];
+    }
+    else if constexpr (Set == MoveSet::QUIETS)
+    {
+        kMoves &= ~m_bbAllPieces;
+    }
+
     while(kMoves)
     {
         square_t target = popLS1B(&kMoves);
-        m_legalMoves[m_numLegalMoves++] = Move(m_kingIdx, target, MoveInfoBit::KING_MOVE);
+        moves.add(Move(m_kingIdx, target, MoveInfoBit::KING_MOVE));
     }
 
-    // Castle
-    static constexpr bitboard_t WhiteQueenCastlePieceMask   = 0x0ELL;
-    static constexpr bitboard_t WhiteQueenCastleAttackMask  = 0x0CLL;
-    static constexpr bitboard_t WhiteKingCastleMask         = 0x60LL;
-    static constexpr bitboard_t BlackQueenCastlePieceMask   = 0x0E00000000000000LL;
-    static constexpr bitboard_t BlackQueenCastleAttackMask  = 0x0C00000000000000LL;
-    static constexpr bitboard_t BlackKingCastleMask         = 0x6000000000000000LL;
+    if constexpr ((Set == MoveSet::CAPTURES) || (Set == MoveSet::NOISY))
+    {
+        return;
+    }
 
+    // Castle
     // The following code assumes that the king is not in check
     // It works by checking that the squares which the rook and the king moves over are free,
     // and that the squares which the king moves over and steps into are not attacked by the opponent
@@ -771,65 +861,167 @@ Move* Board::getLegalMoves()
     if(m_turn == WHITE)
     {
         if(m_castleRights & CastleRights::WHITE_QUEEN_SIDE)
-            if(!(m_bbAllPieces & WhiteQueenCastlePieceMask) && !(opponentAttacks & WhiteQueenCastleAttackMask))
-                m_legalMoves[m_numLegalMoves++] = Move(Square::E1, Square::C1, MoveInfoBit::CASTLE_WHITE_QUEEN | MoveInfoBit::KING_MOVE);
+            if(!(m_bbAllPieces & CastlePieceMasks[CASTLE_WHITE_QUEEN_INDEX]) && !(opponentAttacks & CastleAttackMasks[CASTLE_WHITE_QUEEN_INDEX]))
+                moves.add(Move(Square::E1, Square::C1, MoveInfoBit::CASTLE_WHITE_QUEEN | MoveInfoBit::KING_MOVE));
 
         if(m_castleRights & CastleRights::WHITE_KING_SIDE)
-            if(!((m_bbAllPieces | opponentAttacks) & WhiteKingCastleMask))
-                m_legalMoves[m_numLegalMoves++] = Move(Square::E1, Square::G1, MoveInfoBit::CASTLE_WHITE_KING | MoveInfoBit::KING_MOVE);
+            if(!(m_bbAllPieces & CastlePieceMasks[CASTLE_WHITE_KING_INDEX]) && !(opponentAttacks & CastleAttackMasks[CASTLE_WHITE_KING_INDEX]))
+                moves.add(Move(Square::E1, Square::G1, MoveInfoBit::CASTLE_WHITE_KING | MoveInfoBit::KING_MOVE));
     }
     else
     {
         if(m_castleRights & CastleRights::BLACK_QUEEN_SIDE)
-            if(!(m_bbAllPieces & BlackQueenCastlePieceMask) && !(opponentAttacks & BlackQueenCastleAttackMask))
-                m_legalMoves[m_numLegalMoves++] = Move(Square::E8, Square::C8, MoveInfoBit::CASTLE_BLACK_QUEEN | MoveInfoBit::KING_MOVE);
+            if(!(m_bbAllPieces & CastlePieceMasks[CASTLE_BLACK_QUEEN_INDEX]) && !(opponentAttacks & CastleAttackMasks[CASTLE_BLACK_QUEEN_INDEX]))
+                moves.add(Move(Square::E8, Square::C8, MoveInfoBit::CASTLE_BLACK_QUEEN | MoveInfoBit::KING_MOVE));
 
         if(m_castleRights & CastleRights::BLACK_KING_SIDE)
-            if(!((m_bbAllPieces | opponentAttacks) & BlackKingCastleMask))
-                m_legalMoves[m_numLegalMoves++] = Move(Square::E8, Square::G8, MoveInfoBit::CASTLE_BLACK_KING | MoveInfoBit::KING_MOVE);
+            if(!(m_bbAllPieces & CastlePieceMasks[CASTLE_BLACK_KING_INDEX]) && !(opponentAttacks & CastleAttackMasks[CASTLE_BLACK_KING_INDEX]))
+                moves.add(Move(Square::E8, Square::G8, MoveInfoBit::CASTLE_BLACK_KING | MoveInfoBit::KING_MOVE));
+    }
+}
+
+void Board::generateLegalMoves(MoveList& moves)
+{
+    if(isChecked())
+    {
+        generateLegalMovesFromCheck(moves);
+        return;
     }
 
-    return m_legalMoves;
+    m_generateMoveSet<MoveSet::ALL, true>(moves);
 }
 
-Move* Board::getLegalCaptureMoves()
+// Counts the legal moves without generating them when not in check
+uint8_t Board::countLegalMoves()
 {
-    // Safeguard against repeated calls to generate moves
-    if(m_moveset == MoveSet::CAPTURES)
+    // The evasions are generated, as there are few of them
+    if(isChecked())
     {
-        return m_legalMoves;
+        MoveList moves;
+        generateLegalMovesFromCheck(moves);
+        return moves.size;
     }
 
+    m_findPinnedPieces();
+
+    uint8_t count = m_countMoves<MoveInfoBit::ROOK_MOVE>()
+                  + m_countMoves<MoveInfoBit::KNIGHT_MOVE>()
+                  + m_countMoves<MoveInfoBit::BISHOP_MOVE>()
+                  + m_countMoves<MoveInfoBit::QUEEN_MOVE>()
+                  + m_countPawnMoves();
+
+    bitboard_t opponentAttacks = getOpponentAttacks();
+    count += CNTSBITS(getKingMoves(m_kingIdx) & ~(m_bbColoredPieces[m_turn] | opponentAttacks));
+
+    for(uint8_t castleIndex = 2 * m_turn; castleIndex < 2 * m_turn + 2; castleIndex++)
+    {
+        if((m_castleRights & (1 << castleIndex))
+        && !(m_bbAllPieces & CastlePieceMasks[castleIndex])
+        && !(opponentAttacks & CastleAttackMasks[castleIndex]))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// Generates captures and queen promotions
+void Board::generateLegalCaptureMoves(MoveList& moves)
+{
     // If in check, the existing function for generating legal moves will be used
     if(isChecked())
     {
-        return getLegalMovesFromCheck();
+        generateLegalMovesFromCheck(moves);
+        return;
+    }
+
+    m_generateMoveSet<MoveSet::CAPTURES, true>(moves);
+}
+
+// Generates pseudo-legal captures and queen promotions
+// If in check, the legal evasions are generated
+void Board::generatePseudoLegalCaptureMoves(MoveList& moves)
+{
+    if(isChecked())
+    {
+        generateLegalMovesFromCheck(moves);
+        return;
+    }
+
+    m_generateMoveSet<MoveSet::CAPTURES, false>(moves);
+}
+
+// Generates pseudo-legal captures and all promotions
+// Together with generatePseudoLegalQuietMoves, this generates all pseudo-legal moves
+void Board::generatePseudoLegalNoisyMoves(MoveList& moves)
+{
+    // If in check, all legal evasions are generated with the noisy moves
+    if(isChecked())
+    {
+        generateLegalMovesFromCheck(moves);
+        return;
     }
 
-    m_moveset = MoveSet::CAPTURES;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
+    m_generateMoveSet<MoveSet::NOISY, false>(moves);
+}
+
+// Generates pseudo-legal moves which are neither captures nor promotions
+void Board::generatePseudoLegalQuietMoves(MoveList& moves)
+{
+    // The evasions are already generated by generatePseudoLegalNoisyMoves
+    if(isChecked())
+    {
+        return;
+    }
+
+    m_generateMoveSet<MoveSet::QUIETS, false>(moves);
+}
+
+// Returns true if the pseudo-legal move does not leave the king in check
+// The check only depends on the pinned pieces, the checking pieces and the attacked squares,
+// such that legality can be checked right before the move is played
+bool Board::isLegal(const Move& move)
+{
+    const bitboard_t bbTo = (1LL << move.to);
+    const Color opponent = Color(m_turn ^ 1);
+
     m_findPinnedPieces();
-    m_numLegalMoves = 0;
-    // Everything below is generating moves when not in check, thus we can filter for capturing moves
-    Color opponent = Color(m_turn ^ 1);
 
-    m_generateMoves<MoveInfoBit::ROOK_MOVE, MoveSet::CAPTURES>();
-    m_generateMoves<MoveInfoBit::KNIGHT_MOVE, MoveSet::CAPTURES>();
-    m_generateMoves<MoveInfoBit::BISHOP_MOVE, MoveSet::CAPTURES>();
-    m_generateMoves<MoveInfoBit::QUEEN_MOVE, MoveSet::CAPTURES>();
-    m_generatePawnMoves<MoveSet::CAPTURES>();
+    if(move.moveInfo & MoveInfoBit::KING_MOVE)
+    {
+        if(move.isCastle())
+        {
+            return !isChecked() && !(getOpponentAttacks() & CastleAttackMasks[move.castleIndex()]);
+        }
 
-    // King moves
-    bitboard_t kMoves = getKingMoves(m_kingIdx);
-    bitboard_t opponentAttacks = getOpponentAttacks();
-    kMoves &= ~(m_bbColoredPieces[m_turn] | opponentAttacks) & m_bbColoredPieces[opponent];
-    while(kMoves)
+        // The opponent attacks are generated without the king, such that the king cannot step away from a slider
+        return !(getOpponentAttacks() & bbTo);
+    }
+
+    if(isChecked())
     {
-        square_t target = popLS1B(&kMoves);
-        m_legalMoves[m_numLegalMoves++] = Move(m_kingIdx, target, MoveInfoBit::KING_MOVE);
+        // With a single checking piece, the move has to capture or block it
+        bitboard_t checkers = attackersTo(m_kingIdx, m_bbAllPieces) & m_bbColoredPieces[opponent];
+        if(CNTSBITS(checkers) > 1)
+        {
+            return false;
+        }
+
+        bitboard_t evasionSquares = getBetweens(m_kingIdx, LS1B(checkers)) | checkers;
+        bool capturesCheckerEnpassant = (move.moveInfo & MoveInfoBit::ENPASSANT) && (m_bbEnPassantTarget & checkers);
+        if(!(bbTo & evasionSquares) && !capturesCheckerEnpassant)
+        {
+            return false;
+        }
     }
 
-    return m_legalMoves;
+    if(move.moveInfo & MoveInfoBit::ENPASSANT)
+    {
+        return m_isLegalEnpassant(move);
+    }
+
+    return m_isLegalMove(move);
 }
 
 // Returns true if a legal move is found
@@ -839,11 +1031,6 @@ Move* Board::getLegalCaptureMoves()
 // checkmate and stalemate at evaluation
 bool Board::hasLegalMove()
 {
-    if((m_moveset == MoveSet::ALL) || (m_numLegalMoves > 0))
-    {
-        return m_numLegalMoves > 0;
-    }
-
     if(isChecked())
         return hasLegalMoveFromCheck();
 
@@ -919,11 +1106,6 @@ bool Board::hasLegalMove()
 
 bool Board::hasLegalMoveFromCheck()
 {
-    if((m_moveset == MoveSet::ALL) || (m_numLegalMoves > 0))
-    {
-        return m_numLegalMoves > 0;
-    }
-
     m_findPinnedPieces();
     Color opponent = Color(m_turn^1);
     bitboard_t bbKing = m_bbTypedPieces[Piece::KING][m_turn];
@@ -1157,26 +1339,15 @@ bool Board::hasOfficers(Color turn) const
     return numPieces > (numPawns + 1);
 }
 
-uint8_t Board::getNumLegalMoves() const
-{
-    return m_numLegalMoves;
-}
-
-void Board::generateCaptureInfo()
+void Board::generateCaptureInfo(MoveList& moves) const
 {
-    // Return early if the capture info is already generated
-    // This can happen if a position is re-searched with a different window
-    if(m_captureInfoGenerated == m_moveset)
-        return;
-
-    m_captureInfoGenerated = m_moveset;
-    for(uint8_t i = 0; i < m_numLegalMoves; i++)
+    for(uint16_t i = 0; i < moves.size; i++)
     {
         // Set the corresponding capture flag. We do not have to worry about enpassant, as it is already included in the moveInfo
-        Piece targetPiece = m_pieces[m_legalMoves[i].to];
+        Piece targetPiece = m_pieces[moves[i].to];
         if(targetPiece != NO_PIECE)
         {
-            m_legalMoves[i].moveInfo |= (MoveInfoBit::CAPTURE_PAWN << targetPiece);
+            moves[i].moveInfo |= (MoveInfoBit::CAPTURE_PAWN << targetPiece);
         }
     }
 }
@@ -1221,6 +1392,82 @@ Move Board::generateMoveWithInfo(square_t from, square_t to, uint32_t promoteInf
     return move;
 }
 
+// Checks that the packed move can be played by the side to move, using only the bitboards of the position
+// The move is pseudo-legal, thus it has to be checked with isLegal() before it is played
+// Used to validate the TT move, which can be from a different position in case of a hash collision
+bool Board::isPseudoLegal(PackedMove packedMove) const
+{
+    const square_t from = packedMove.from();
+    const square_t to = packedMove.to();
+    const bitboard_t bbFrom = (1LL << from);
+    const bitboard_t bbTo = (1LL << to);
+    const Color opponent = Color(m_turn ^ 1);
+
+    // The moved piece has to belong to the side to move, and it cannot capture its own pieces
+    if(!(m_bbColoredPieces[m_turn] & bbFrom) || (m_bbColoredPieces[m_turn] & bbTo))
+    {
+        return false;
+    }
+
+    const Piece movedPiece = m_pieces[from];
+    if(movedPiece == Piece::PAWN)
+    {
+        // Pawn moves to the last rank have to be promotions, and promotions have to be pawn moves to the last rank
+        constexpr bitboard_t PromotionSquares = 0xff000000000000ffLL;
+        if(packedMove.isPromotion() != bool(bbTo & PromotionSquares))
+        {
+            return false;
+        }
+
+        bitboard_t targets = (getPawnMoves(bbFrom, m_turn) & ~m_bbAllPieces)
+                           | getPawnDoubleMoves(bbFrom, m_turn, m_bbAllPieces)
+                           | (getPawnAttacks(bbFrom, m_turn) & (m_bbColoredPieces[opponent] | m_bbEnPassantSquare));
+        return targets & bbTo;
+    }
+
+    if(packedMove.isPromotion())
+    {
+        return false;
+    }
+
+    switch (movedPiece)
+    {
+    case Piece::ROOK:   return getRookMoves(m_bbAllPieces, from) & bbTo;
+    case Piece::KNIGHT: return getKnightMoves(from) & bbTo;
+    case Piece::BISHOP: return getBishopMoves(m_bbAllPieces, from) & bbTo;
+    case Piece::QUEEN:  return getQueenMoves(m_bbAllPieces, from) & bbTo;
+    default: break;
+    }
+
+    if(getKingMoves(from) & bbTo)
+    {
+        return true;
+    }
+
+    // Castling requires the castle right and no pieces between the king and the rook
+    // Squares attacked by the opponent are checked by isLegal()
+    const square_t kingSquare = m_turn == Color::WHITE ? Square::E1 : Square::E8;
+    if((from != kingSquare) || (std::abs(to - from) != 2))
+    {
+        return false;
+    }
+
+    const uint8_t castleIndex = 2 * m_turn + (to > from);
+    return (m_castleRights & (1 << castleIndex)) && !(m_bbAllPieces & CastlePieceMasks[castleIndex]);
+}
+
+// Reconstructs the full move from a packed move
+// Returns NULL_MOVE if the move is not pseudo-legal in the position
+Move Board::decodeTTMove(PackedMove packedMove) const
+{
+    if(!isPseudoLegal(packedMove))
+    {
+        return NULL_MOVE;
+    }
+
+    return generateMoveWithInfo(packedMove.from(), packedMove.to(), packedMove.promotionInfo());
+}
+
 // Checks if enpassant is legal after a double pawn move
 // Shall only be used by performMove when performing a double pawn move
 // It has to be called before any changes are made to the board
@@ -1260,8 +1507,7 @@ bool Board::m_isEnpassantLegalAfterMove(const Move& move)
     while(blockedAttackers)
     {
         square_t blocker = popLS1B(&blockedAttackers);
-        square_t pinner = m_pinnerBlockerIdxPairs[opponent][blocker];
-        if(getBetweens(opponentKingIdx, pinner) & (1LL << m_enPassantSquareCandidate))
+        if(getLine(opponentKingIdx, blocker) & (1LL << m_enPassantSquareCandidate))
         {
             return true;
         }
@@ -1388,14 +1634,11 @@ void Board::performMove(const Move move)
 
     Zobrist::getUpdatedHashes(*this, move, oldEnPassantSquare, m_enPassantSquare, oldCastleRights, m_castleRights, m_hash, m_pawnHash, m_materialHash);
 
-    m_moveset = MoveSet::NOT_GENERATED;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     m_blockersGenerated = MoveSet::NOT_GENERATED;
     m_turn = opponent;
     m_kingIdx = LS1B(m_bbTypedPieces[Piece::KING][m_turn]);
     m_fullMoves += (m_turn == WHITE); // Note: turn is flipped
     m_bbOpponentAttacks = 0LL;
-    m_numLegalMoves = 0;
 
     // Update halfmoves / 50 move rule
     if(move.isCapture() || (move.moveInfo & MoveInfoBit::PAWN_MOVE))
@@ -1424,11 +1667,132 @@ void Board::performNullMove()
     m_bbOpponentAttacks = 0LL;
     m_rule50++;
 
-    m_moveset = MoveSet::NOT_GENERATED;
-    m_captureInfoGenerated = MoveSet::NOT_GENERATED;
     // Blockers and pinners are still the same
 }
 
+inline void Board::m_saveUndoRecord(UndoRecord& undo) const
+{
+    undo.hash = m_hash;
+    undo.pawnHash = m_pawnHash;
+    undo.materialHash = m_materialHash;
+    undo.bbOpponentAttacks = m_bbOpponentAttacks;
+    undo.blockers[Color::WHITE] = m_blockers[Color::WHITE];
+    undo.blockers[Color::BLACK] = m_blockers[Color::BLACK];
+    undo.pinners[Color::WHITE] = m_pinners[Color::WHITE];
+    undo.pinners[Color::BLACK] = m_pinners[Color::BLACK];
+    undo.blockersGenerated = (m_blockersGenerated == MoveSet::ALL);
+    undo.capturedPiece = NO_PIECE;
+    undo.castleRights = m_castleRights;
+    undo.rule50 = m_rule50;
+    undo.enPassantSquareCandidate = m_enPassantSquareCandidate;
+    undo.enPassantSquare = m_enPassantSquare;
+    undo.enPassantTarget = m_enPassantTarget;
+}
+
+inline void Board::m_restoreUndoRecord(const UndoRecord& undo)
+{
+    m_hash = undo.hash;
+    m_pawnHash = undo.pawnHash;
+    m_materialHash = undo.materialHash;
+    m_bbOpponentAttacks = undo.bbOpponentAttacks;
+    m_blockers[Color::WHITE] = undo.blockers[Color::WHITE];
+    m_blockers[Color::BLACK] = undo.blockers[Color::BLACK];
+    m_pinners[Color::WHITE] = undo.pinners[Color::WHITE];
+    m_pinners[Color::BLACK] = undo.pinners[Color::BLACK];
+    m_blockersGenerated = undo.blockersGenerated ? MoveSet::ALL : MoveSet::NOT_GENERATED;
+    m_castleRights = undo.castleRights;
+    m_rule50 = undo.rule50;
+    m_enPassantSquareCandidate = undo.enPassantSquareCandidate;
+    m_enPassantSquare = undo.enPassantSquare;
+    m_enPassantTarget = undo.enPassantTarget;
+    m_bbEnPassantSquare = (m_enPassantSquare == Square::NONE) ? 0LL : (1LL << m_enPassantSquare);
+    m_bbEnPassantTarget = (m_enPassantTarget == Square::NONE) ? 0LL : (1LL << m_enPassantTarget);
+
+    m_turn = Color(m_turn ^ 1);
+    m_kingIdx = LS1B(m_bbTypedPieces[Piece::KING][m_turn]);
+}
+
+// Performs the move in place and stores the state required to unmake it
+void Board::makeMove(const Move& move, UndoRecord& undo)
+{
+    m_saveUndoRecord(undo);
+    undo.capturedPiece = m_pieces[move.to];
+    performMove(move);
+}
+
+// Unmakes a move performed by makeMove, restoring the position before the move
+void Board::unmakeMove(const Move& move, const UndoRecord& undo)
+{
+    const Color opponent = m_turn;
+    const Color turn = Color(m_turn ^ 1);
+    const bitboard_t bbFrom = 1LL << move.from;
+    const bitboard_t bbTo = 1LL << move.to;
+
+    // Move the piece back, replacing promoted pieces with the pawn
+    const Piece movedPiece = m_pieces[move.to];
+    m_bbTypedPieces[movedPiece][turn] &= ~bbTo;
+    if(move.isPromotion())
+    {
+        m_bbTypedPieces[Piece::PAWN][turn] |= bbFrom;
+        m_pieces[move.from] = Piece::PAWN;
+    }
+    else
+    {
+        m_bbTypedPieces[movedPiece][turn] |= bbFrom;
+        m_pieces[move.from] = movedPiece;
+    }
+    m_pieces[move.to] = NO_PIECE;
+    m_bbColoredPieces[turn] = (m_bbColoredPieces[turn] & ~bbTo) | bbFrom;
+    m_bbAllPieces = (m_bbAllPieces & ~bbTo) | bbFrom;
+
+    // Restore captured pieces
+    if(undo.capturedPiece != NO_PIECE)
+    {
+        m_pieces[move.to] = undo.capturedPiece;
+        m_bbTypedPieces[undo.capturedPiece][opponent] |= bbTo;
+        m_bbColoredPieces[opponent] |= bbTo;
+        m_bbAllPieces |= bbTo;
+    }
+    else if(move.moveInfo & MoveInfoBit::ENPASSANT)
+    {
+        const bitboard_t bbTarget = 1LL << undo.enPassantTarget;
+        m_pieces[undo.enPassantTarget] = Piece::PAWN;
+        m_bbTypedPieces[Piece::PAWN][opponent] |= bbTarget;
+        m_bbColoredPieces[opponent] |= bbTarget;
+        m_bbAllPieces |= bbTarget;
+    }
+
+    // Move the rook back in the case of castling
+    if(move.isCastle())
+    {
+        const CastleIndex castleIndex = move.castleIndex();
+        const square_t rookFrom = Move::CastleRookFrom[castleIndex];
+        const square_t rookTo   = Move::CastleRookTo[castleIndex];
+        const bitboard_t bbRookFrom = 1LL << rookFrom;
+        const bitboard_t bbRookTo   = 1LL << rookTo;
+
+        m_bbTypedPieces[Piece::ROOK][turn] = (m_bbTypedPieces[Piece::ROOK][turn] & ~bbRookTo) | bbRookFrom;
+        m_bbColoredPieces[turn] = (m_bbColoredPieces[turn] & ~bbRookTo) | bbRookFrom;
+        m_bbAllPieces = (m_bbAllPieces & ~bbRookTo) | bbRookFrom;
+        m_pieces[rookFrom] = Piece::ROOK;
+        m_pieces[rookTo] = Piece::NO_PIECE;
+    }
+
+    m_fullMoves -= (turn == BLACK);
+    m_restoreUndoRecord(undo);
+}
+
+void Board::makeNullMove(UndoRecord& undo)
+{
+    m_saveUndoRecord(undo);
+    performNullMove();
+}
+
+void Board::unmakeNullMove(const UndoRecord& undo)
+{
+    m_restoreUndoRecord(undo);
+}
+
 bool Board::isEnPassantPossible()
 {
     if(m_enPassantSquare == Square::NONE)
@@ -8,8 +8,12 @@
 
 namespace Arcanum
 {
+    // Maximum number of legal moves in a position
     constexpr uint8_t MaxMoveCount = 218;
 
+    // Capacity for the pseudo-legal moves of the staged move generation, which also include moves of pinned pieces
+    constexpr uint16_t MaxPseudoLegalMoveCount = 256;
+
     typedef enum CastleRights : uint8_t
     {
         WHITE_QUEEN_SIDE = 1,
@@ -18,6 +22,41 @@ namespace Arcanum
         BLACK_KING_SIDE = 8,
     } CastleRights;
 
+    // Moves generated for a position
+    // The list is owned by the caller, such that the board does not store any moves
+    struct MoveList
+    {
+        Move moves[MaxPseudoLegalMoveCount];
+        uint16_t size;
+
+        MoveList() : size(0) {}
+        inline void add(const Move& move) { moves[size++] = move; }
+        inline Move& operator[](uint16_t index) { return moves[index]; }
+        inline const Move& operator[](uint16_t index) const { return moves[index]; }
+        inline Move* begin() { return moves; }
+        inline Move* end() { return moves + size; }
+        inline const Move* begin() const { return moves; }
+        inline const Move* end() const { return moves + size; }
+    };
+
+    // State which cannot be recovered from the move when it is unmade
+    struct UndoRecord
+    {
+        hash_t hash;
+        hash_t pawnHash;
+        hash_t materialHash;
+        bitboard_t bbOpponentAttacks;
+        bitboard_t blockers[NUM_COLORS];
+        bitboard_t pinners[NUM_COLORS];
+        bool blockersGenerated; // Set if the blockers and pinners were generated for the position
+        Piece capturedPiece;
+        uint8_t castleRights;
+        uint8_t rule50;
+        square_t enPassantSquareCandidate;
+        square_t enPassantSquare;
+        square_t enPassantTarget;
+    };
+
     class Board
     {
         private:
@@ -37,13 +76,10 @@ namespace Arcanum
             bitboard_t m_bbTypedPieces[6][NUM_COLORS];
             bitboard_t m_blockers[NUM_COLORS]; // Pieces blocking the king from a sliding piece
             bitboard_t m_pinners[NUM_COLORS];  // Pieces which targets the king with only one opponent piece blocking
-            square_t m_pinnerBlockerIdxPairs[NUM_COLORS][64]; // Lookup from blockerIdx to the corresponding pinnerIdx. The color is the color of the king
             bitboard_t m_bbOpponentAttacks;
             square_t m_kingIdx;
 
             Piece m_pieces[64];
-            uint8_t m_numLegalMoves = 0;
-            Move m_legalMoves[MaxMoveCount];
             hash_t m_hash;
             hash_t m_materialHash;
             hash_t m_pawnHash;
@@ -51,11 +87,11 @@ namespace Arcanum
             enum MoveSet
             {
                 NOT_GENERATED,
-                CAPTURES,
+                CAPTURES, // Captures and queen promotions
+                NOISY,    // Captures and all promotions
+                QUIETS,   // Moves which are neither captures nor promotions
                 ALL,
             };
-            MoveSet m_moveset; // Which set moves are generated
-            MoveSet m_captureInfoGenerated;
             MoveSet m_blockersGenerated;
 
             friend class Zobrist;
@@ -64,32 +100,52 @@ namespace Arcanum
             friend class BinpackEncoder;
 
             // Tests if the king will be checked before adding the move
-            bool m_attemptAddPseudoLegalEnpassant(Move move);
-            bool m_attemptAddPseudoLegalMove(Move move);
+            template <bool Legal = true>
+            bool m_attemptAddPseudoLegalEnpassant(MoveList& moves, Move move);
+            template <bool Legal = true>
+            bool m_attemptAddPseudoLegalMove(MoveList& moves, Move move);
             bool m_isLegalEnpassant(Move move) const;
             bool m_isLegalMove(Move move) const;
             bitboard_t m_getLeastValuablePiece(const bitboard_t mask, const Color color, Piece& piece) const;
             void m_findPinnedPieces();
             bool m_isEnpassantLegalAfterMove(const Move& move);
+            void m_saveUndoRecord(UndoRecord& undo) const;
+            void m_restoreUndoRecord(const UndoRecord& undo);
+
+            template <MoveInfoBit MoveType, MoveSet Set, bool Legal>
+            void m_generateMoves(MoveList& moves);
 
-            template <MoveInfoBit MoveType, MoveSet Set>
-            void m_generateMoves();
+            template <MoveSet Set, bool Legal>
+            void m_generatePawnMoves(MoveList& moves);
 
-            template <MoveSet Set>
-            void m_generatePawnMoves();
+            template <bool Queen, bool UnderPromotions, bool Legal>
+            void m_addPromotions(MoveList& moves, square_t pawnIdx, square_t target);
+
+            template <MoveSet Set, bool Legal>
+            void m_generateMoveSet(MoveList& moves);
 
             template <MoveInfoBit MoveType>
             bool m_hasMove();
 
+            template <MoveInfoBit MoveType>
+            uint8_t m_countMoves() const;
+            uint8_t m_countPawnMoves() const;
+
         public:
             Board();
             Board(const Board& board);
             explicit Board(const std::string fen, bool strict = true);
             Board& operator=(const Board& other) = default;
             void performMove(const Move move);
-            void generateCaptureInfo();
+            void generateCaptureInfo(MoveList& moves) const;
             Move generateMoveWithInfo(square_t from, square_t to, uint32_t promoteInfo) const;
+            bool isPseudoLegal(PackedMove packedMove) const;
+            Move decodeTTMove(PackedMove packedMove) const;
             void performNullMove();
+            void makeMove(const Move& move, UndoRecord& undo);
+            void unmakeMove(const Move& move, const UndoRecord& undo);
+            void makeNullMove(UndoRecord& undo);
+            void unmakeNullMove(const UndoRecord& undo);
             hash_t getHash() const;
             hash_t getPawnHash() const;
             hash_t getMaterialHash() const;
@@ -108,12 +164,17 @@ namespace Arcanum
             Color getColorAt(square_t square) const;
             square_t getEnpassantSquare() const;
             square_t getEnpassantTarget() const;
-            Move* getLegalMovesFromCheck();
-            Move* getLegalMoves();
-            Move* getLegalCaptureMoves();
+            // Moves are appended to the list
+            void generateLegalMovesFromCheck(MoveList& moves);
+            void generateLegalMoves(MoveList& moves);
+            void generateLegalCaptureMoves(MoveList& moves);
+            void generatePseudoLegalCaptureMoves(MoveList& moves);
+            void generatePseudoLegalNoisyMoves(MoveList& moves);
+            void generatePseudoLegalQuietMoves(MoveList& moves);
+            uint8_t countLegalMoves();
+            bool isLegal(const Move& move);
             uint8_t numOfficers(Color turn) const;
             bool hasOfficers(Color turn) const;
-            uint8_t getNumLegalMoves() const;
             uint8_t getNumPieces() const;
             uint8_t getNumColoredPieces(Color color) const;
             bitboard_t attackersTo(square_t square, bitboard_t occupancy) const;
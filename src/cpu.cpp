@@ -0,0 +1,70 @@
+#include <cpu.hpp>
+#include <utils.hpp>
+
+#if defined(__x86_64__) && defined(USE_AVX512)
+    #include <cpuid.h>
+#endif
+
+using namespace Arcanum;
+
+#if defined(__x86_64__) && defined(USE_AVX512)
+// Reads the XCR0 register, which holds the register states saved by the OS on context switches
+static uint64_t readXCR0()
+{
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t(edx) << 32) | eax;
+}
+#endif
+
+Cpu::InstructionSet Cpu::m_detectInstructionSet()
+{
+    #if defined(__x86_64__) && defined(USE_AVX512)
+    uint32_t eax, ebx, ecx, edx;
+
+    // The OS has to enable XGETBV (OSXSAVE) for the register state to be queried
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1 << 27)))
+    {
+        return AVX2;
+    }
+
+    // The OS has to save the XMM, YMM, opmask and both halves of the upper ZMM registers
+    constexpr uint64_t Avx512State = 0b11100110;
+    if((readXCR0() & Avx512State) != Avx512State)
+    {
+        return AVX2;
+    }
+
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return AVX2;
+    }
+
+    bool avx512f    = ebx & (1 << 16);
+    bool avx512bw   = ebx & (1 << 30);
+    bool avx512vnni = ecx & (1 << 11);
+
+    if(avx512f && avx512bw)
+    {
+        return avx512vnni ? AVX512_VNNI : AVX512;
+    }
+    #endif
+
+    return AVX2;
+}
+
+Cpu::InstructionSet Cpu::getInstructionSet()
+{
+    static const InstructionSet instructionSet = m_detectInstructionSet();
+    return instructionSet;
+}
+
+const char* Cpu::getInstructionSetName(InstructionSet instructionSet)
+{
+    switch(instructionSet)
+    {
+        case AVX512_VNNI: return "AVX-512 VNNI";
+        case AVX512:      return "AVX-512";
+        default:          return "AVX2";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <types.hpp>
+
+namespace Arcanum
+{
+    // Instruction set extensions found by cpuid when the engine starts.
+    // The build targets AVX2, and the wider kernels are only selected
+    // when both the CPU and the OS support them.
+    class Cpu
+    {
+        public:
+            enum InstructionSet : uint8_t
+            {
+                AVX2,
+                AVX512,      // AVX-512F and AVX-512BW
+                AVX512_VNNI, // AVX-512 with VNNI (vpdpbusd)
+            };
+
+            static InstructionSet getInstructionSet();
+            static const char* getInstructionSetName(InstructionSet instructionSet);
+        private:
+            static InstructionSet m_detectInstructionSet();
+    };
+}
\ No newline at end of file
@@ -34,6 +34,7 @@ void Evaluator::initAccumulatorStack(const Board& board)
     nnue.initializeAccumulator(m_accumulatorStack[0], board);
     m_accumulatorUpdates[0].updated[Color::WHITE] = true;
     m_accumulatorUpdates[0].updated[Color::BLACK] = true;
+    m_accumulatorUpdates[0].hasEval = false;
 }
 
 void Evaluator::pushMoveToAccumulator(const Board& board, const Move& move)
@@ -47,11 +48,35 @@ void Evaluator::pushMoveToAccumulator(const Board& board, const Move& move)
     // Calculate the NNUE deltas
     m_accumulatorUpdates[m_accumulatorStackIndex + 1].updated[Color::WHITE] = false;
     m_accumulatorUpdates[m_accumulatorStackIndex + 1].updated[Color::BLACK] = false;
+    m_accumulatorUpdates[m_accumulatorStackIndex + 1].hasEval = false;
     NNUE::findDeltaFeatures(board, move, m_accumulatorUpdates[m_accumulatorStackIndex + 1].deltaFeatures);
 
     m_accumulatorStackIndex++;
 }
 
+void Evaluator::pushMoveToAccumulator(const Board& board, const Move& move, eval_t eval)
+{
+    pushMoveToAccumulator(board, move);
+    m_accumulatorUpdates[m_accumulatorStackIndex].hasEval = true;
+    m_accumulatorUpdates[m_accumulatorStackIndex].eval = eval;
+}
+
+void Evaluator::evaluateMoves(const Board& board, const Move* const* moves, uint8_t numMoves, eval_t* evals)
+{
+    NNUE::DeltaFeatures deltaFeatures[NNUE::MaxBatchSize];
+    uint32_t buckets[NNUE::MaxBatchSize];
+    for(uint8_t i = 0; i < numMoves; i++)
+    {
+        NNUE::findDeltaFeatures(board, *moves[i], deltaFeatures[i]);
+        buckets[i] = NNUE::getOutputBucket(uint8_t(board.getNumPieces() - moves[i]->isCapture()));
+    }
+
+    // The evals are from the perspective of the side to move after the moves
+    Color perspective = Color(board.getTurn() ^ 1);
+    m_propagateAccumulatorUpdates(perspective);
+    nnue.predictBatch(m_accumulatorStack[m_accumulatorStackIndex], deltaFeatures, buckets, numMoves, perspective, evals);
+}
+
 void Evaluator::m_propagateAccumulatorUpdates(Color perspective)
 {
     // Find a root where the accumulator is updated by walking the stack
@@ -132,21 +157,18 @@ eval_t Evaluator::clampEval(eval_t eval)
     return std::clamp(eval, LowerMargin, UpperMargin);
 }
 
+eval_t Evaluator::getTerminalScore(bool isChecked, uint8_t plyFromRoot)
+{
+    return isChecked ? -MateScore + plyFromRoot : 0;
+}
+
 // Positive values represents advantage for current player
-eval_t Evaluator::evaluate(Board& board, uint8_t plyFromRoot)
+eval_t Evaluator::evaluate(const Board& board)
 {
-    // Check for stalemate and checkmate
-    if(!board.hasLegalMove())
+    if(m_accumulatorUpdates[m_accumulatorStackIndex].hasEval)
     {
-        // Checkmate
-        if(board.isChecked())
-        {
-            return -MateScore + plyFromRoot;
-        }
-
-        // Stalemate
-        return 0;
-    };
+        return m_accumulatorUpdates[m_accumulatorStackIndex].eval;
+    }
 
     m_propagateAccumulatorUpdates(board.getTurn());
     return nnue.predict(m_accumulatorStack[m_accumulatorStackIndex], board);
@@ -12,6 +12,8 @@ namespace Arcanum
             struct AccumulatorUpdateInfo
             {
                 bool updated[2];
+                bool hasEval; // The eval is known from evaluateMoves
+                eval_t eval;
                 NNUE::DeltaFeatures deltaFeatures;
             };
 
@@ -42,15 +44,23 @@ namespace Arcanum
             static eval_t clampEval(eval_t eval);
             // Gets the distance to mate from a real mate score
             static int32_t getMateDistance(eval_t eval);
+            // Gets the score of a position without legal moves, which is checkmate if in check and stalemate otherwise
+            static eval_t getTerminalScore(bool isChecked, uint8_t plyFromRoot);
 
             static NNUE nnue;
 
             Evaluator();
             ~Evaluator();
-            eval_t evaluate(Board& board, uint8_t plyFromRoot);
+            // Checkmate and stalemate are not detected, as the search detects them from the number of legal moves
+            eval_t evaluate(const Board& board);
 
             void initAccumulatorStack(const Board& board);
             void pushMoveToAccumulator(const Board& board, const Move& move);
+            // Pushes a move with the eval found by evaluateMoves, such that the accumulator is only updated if needed by later moves
+            void pushMoveToAccumulator(const Board& board, const Move& move, eval_t eval);
+            // Evaluates the positions after each of the moves in one pass over the accumulator of the board
+            // At most NNUE::MaxBatchSize moves can be evaluated at once
+            void evaluateMoves(const Board& board, const Move* const* moves, uint8_t numMoves, eval_t* evals);
             void popMoveFromAccumulator();
     };
 }
\ No newline at end of file
@@ -393,8 +393,6 @@ bool FEN::setFEN(Board& board, const std::string& fen, bool strict)
     }
 
     // Set cache to unknown
-    board.m_moveset = Board::MoveSet::NOT_GENERATED;
-    board.m_captureInfoGenerated = Board::MoveSet::NOT_GENERATED;
     board.m_blockersGenerated = Board::MoveSet::NOT_GENERATED;
     board.m_kingIdx = LS1B(board.m_bbTypedPieces[Piece::KING][board.m_turn]);
     board.m_bbOpponentAttacks = 0LL;
@@ -641,9 +639,10 @@ Move FEN::getMoveFromAlgebraic(std::string token, Board& board)
 
     // Find the correct move based on the required match info
     find_move:
-    Move* moves = board.getLegalMoves();
-    uint8_t numMoves = board.getNumLegalMoves();
-    board.generateCaptureInfo();
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    board.generateCaptureInfo(moves);
+    uint8_t numMoves = moves.size;
 
     for(uint8_t i = 0; i < numMoves; i++)
     {
@@ -693,9 +692,10 @@ std::string FEN::getAlgebraicFromMove(const Move& move, Board& board)
     }
 
     // Check if the move is ambiguous
-    Move* moves = board.getLegalMoves();
-    uint8_t numMoves = board.getNumLegalMoves();
-    board.generateCaptureInfo();
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    board.generateCaptureInfo(moves);
+    uint8_t numMoves = moves.size;
 
     bool uniqueFile = true;
     bool uniqueRank = true;
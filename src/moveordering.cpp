@@ -9,13 +9,13 @@ static const uint16_t s_pieceValues[6]
     100, 500, 300, 300, 900, 1000
 };
 
-inline void MoveSelector::m_scoreMoves()
+inline void MoveSelector::m_scoreMoves(uint16_t begin, uint16_t end)
 {
     Color turn = m_board->getTurn();
 
     Move prevMove = m_plyFromRoot == 0 ? NULL_MOVE : m_moveStack[m_plyFromRoot - 1];
 
-    for(uint8_t i = 0; i < m_numMoves; i++)
+    for(uint16_t i = begin; i < end; i++)
     {
         const Move& move = m_moves[i];
 
@@ -64,18 +64,48 @@ inline void MoveSelector::m_scoreMoves()
         int32_t quietScore = m_heuristics->quietHistory.get(move, turn);
         quietScore += m_heuristics->continuationHistory.get(m_moveStack, m_plyFromRoot, move, turn);
         m_numQuiets++;
-        m_movesAndScores[MaxMoveCount - m_numQuiets].score = quietScore;
-        m_movesAndScores[MaxMoveCount - m_numQuiets].index = i;
+        m_movesAndScores[MaxPseudoLegalMoveCount - m_numQuiets].score = quietScore;
+        m_movesAndScores[MaxPseudoLegalMoveCount - m_numQuiets].index = i;
     }
+}
+
+// Generates and scores the captures and promotions
+// When in check, all moves are generated
+inline void MoveSelector::m_generateNoisyMoves()
+{
+    if(m_noisyGenerated)
+        return;
+
+    m_noisyGenerated = true;
+    m_board->generatePseudoLegalNoisyMoves(m_moveList);
+    m_board->generateCaptureInfo(m_moveList);
+    m_numMoves = m_moveList.size;
+    m_scoreMoves(0, m_numMoves);
 
     m_captureMovesAndScores = &m_movesAndScores[0];
-    m_quietMovesAndScores   = &m_movesAndScores[MaxMoveCount - m_numQuiets];
+    m_quietMovesAndScores   = &m_movesAndScores[MaxPseudoLegalMoveCount - m_numQuiets];
     m_badCaptureMovesAndScores = &m_movesAndScores[m_numCaptures];
 }
 
+// Generates and scores the quiet moves
+// The quiet moves are scored into the back of m_movesAndScores, and do not affect the captures
+inline void MoveSelector::m_generateQuietMoves()
+{
+    if(m_quietsGenerated)
+        return;
+
+    m_quietsGenerated = true;
+    uint16_t begin = m_moveList.size;
+    m_board->generatePseudoLegalQuietMoves(m_moveList);
+    m_numMoves = m_moveList.size;
+    m_scoreMoves(begin, m_numMoves);
+
+    m_quietMovesAndScores = &m_movesAndScores[MaxPseudoLegalMoveCount - m_numQuiets];
+}
+
 MoveSelector::MoveSelector(
     const Move *moves,
-    const uint8_t numMoves,
+    const uint16_t numMoves,
     int plyFromRoot,
     MoveOrderHeuristics* heuristics,
     Board *board,
@@ -94,6 +124,9 @@ MoveSelector::MoveSelector(
     m_numQuiets = 0;
     m_numBadCaptures = 0;
     m_nextBadCapture = 0;
+    m_noisyGenerated = true;
+    m_quietsGenerated = true;
+    m_moveFromTT = ttMove;
 
     // If there is only a single move, set it as the TT move to avoid scoring and sorting it
     if(m_numMoves == 1)
@@ -103,12 +136,26 @@ MoveSelector::MoveSelector(
     }
 
     m_heuristics = heuristics;
-    m_moveFromTT = ttMove;
     m_moveStack = moveStack;
     m_board = board;
     m_plyFromRoot = plyFromRoot;
 
-    m_scoreMoves();
+    m_scoreMoves(0, m_numMoves);
+    m_captureMovesAndScores = &m_movesAndScores[0];
+    m_quietMovesAndScores   = &m_movesAndScores[MaxPseudoLegalMoveCount - m_numQuiets];
+    m_badCaptureMovesAndScores = &m_movesAndScores[m_numCaptures];
+}
+
+MoveSelector::MoveSelector(
+    int plyFromRoot,
+    MoveOrderHeuristics* heuristics,
+    Board *board,
+    const Move ttMove,
+    const Move* moveStack
+) : MoveSelector(m_moveList.moves, 0, plyFromRoot, heuristics, board, ttMove, moveStack)
+{
+    m_noisyGenerated = false;
+    m_quietsGenerated = false;
 }
 
 const Move* MoveSelector::getNextMove()
@@ -116,6 +163,21 @@ const Move* MoveSelector::getNextMove()
     switch (m_phase)
     {
     case Phase::TT_PHASE:
+        // When the moves are generated by the selector, the TT move has been validated by Board::decodeTTMove()
+        // and is played before any moves are generated. When in check, all evasions are generated first
+        // to know the number of moves, and the TT move is only played if it is found among them
+        if(!m_noisyGenerated && !m_moveFromTT.isNull())
+        {
+            if(m_board->isChecked())
+            {
+                m_generateNoisyMoves();
+            }
+            else if(!m_skipQuiets || !m_moveFromTT.isQuiet())
+            {
+                m_ttMove = &m_moveFromTT;
+            }
+        }
+
         if(m_ttMove)
         {
             m_phase = Phase::GOOD_CAPTURES_PHASE;
@@ -125,6 +187,7 @@ const Move* MoveSelector::getNextMove()
 
     case Phase::GOOD_CAPTURES_PHASE:
         m_phase = Phase::GOOD_CAPTURES_PHASE;
+        m_generateNoisyMoves();
         while(m_numCaptures > 0)
         {
             MoveAndScore moveAndScore = popBestMoveAndScore(m_captureMovesAndScores, m_numCaptures--);
@@ -146,6 +209,13 @@ const Move* MoveSelector::getNextMove()
 
     case Phase::KILLERS_PHASE:
         m_phase = Phase::KILLERS_PHASE;
+        // The killers and counters are found among the quiet moves,
+        // thus they are not played if the quiets are skipped before they are generated
+        if(!m_skipQuiets)
+        {
+            m_generateQuietMoves();
+        }
+
         if(m_numKillers > 0)
         {
             return m_killers[--m_numKillers];
@@ -184,10 +254,10 @@ const Move* MoveSelector::getNextMove()
     }
 }
 
-MoveSelector::MoveAndScore MoveSelector::popBestMoveAndScore(MoveAndScore* list, uint8_t numElements)
+MoveSelector::MoveAndScore MoveSelector::popBestMoveAndScore(MoveAndScore* list, uint16_t numElements)
 {
     MoveAndScore *best = list;
-    for(uint8_t i = 1; i < numElements; i++)
+    for(uint16_t i = 1; i < numElements; i++)
     {
         if(best->score < list[i].score)
         {
@@ -215,11 +285,18 @@ bool MoveSelector::isSkippingQuiets()
 
 // Returns the number of quiet moves left in the move selector
 // This exludes TT, killers and counters
-uint8_t MoveSelector::getNumQuietsLeft()
+uint16_t MoveSelector::getNumQuietsLeft()
 {
     return m_numQuiets;
 }
 
+// Returns the number of moves generated so far
+// When in check, all moves are generated before the first move is returned
+uint16_t MoveSelector::getNumMoves() const
+{
+    return m_numMoves;
+}
+
 void MoveSelector::skipQuiets()
 {
     m_skipQuiets = true;
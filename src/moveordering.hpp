@@ -43,20 +43,34 @@ namespace Arcanum
                 BAD_CAPTURES_PHASE,
             };
 
+            // Selects from moves which are already generated
             MoveSelector(
                 const Move *moves,
-                const uint8_t numMoves,
+                const uint16_t numMoves,
                 int plyFromRoot,
                 MoveOrderHeuristics* heuristics,
                 Board *board,
                 const Move ttMove,
                 const Move* moveStack
             );
+            // Generates the moves of the board in stages, when the selector reaches the corresponding phase
+            // The moves are pseudo-legal, and have to be checked with Board::isLegal() before they are played
+            // The TT move has to be pseudo-legal, as it is played before any moves are generated (see Board::decodeTTMove())
+            MoveSelector(
+                int plyFromRoot,
+                MoveOrderHeuristics* heuristics,
+                Board *board,
+                const Move ttMove,
+                const Move* moveStack
+            );
+            MoveSelector(const MoveSelector&) = delete;
+            MoveSelector& operator=(const MoveSelector&) = delete;
             const Move* getNextMove();
             Phase getPhase() const;
             void skipQuiets();
             bool isSkippingQuiets();
-            uint8_t getNumQuietsLeft();
+            uint16_t getNumQuietsLeft();
+            uint16_t getNumMoves() const;
 
         private:
             struct MoveAndScore
@@ -65,7 +79,7 @@ namespace Arcanum
                 int32_t score;
             };
 
-            static MoveAndScore popBestMoveAndScore(MoveAndScore* list, uint8_t numElements);
+            static MoveAndScore popBestMoveAndScore(MoveAndScore* list, uint16_t numElements);
 
             Phase m_phase;
             const Move* m_moves;
@@ -74,24 +88,29 @@ namespace Arcanum
             Board* m_board;
             MoveOrderHeuristics* m_heuristics;
             Move m_moveFromTT;
-            uint8_t m_numMoves;
+            uint16_t m_numMoves;
+            bool m_noisyGenerated;
+            bool m_quietsGenerated;
 
             bool m_skipQuiets;
             uint8_t m_numKillers;
-            uint8_t m_numCaptures;
-            uint8_t m_numBadCaptures;
-            uint8_t m_nextBadCapture;
-            uint8_t m_numQuiets;
+            uint16_t m_numCaptures;
+            uint16_t m_numBadCaptures;
+            uint16_t m_nextBadCapture;
+            uint16_t m_numQuiets;
 
             const Move* m_ttMove;
             const Move* m_killers[2];
             const Move* m_counter;
 
-            MoveAndScore m_movesAndScores[MaxMoveCount];
+            MoveAndScore m_movesAndScores[MaxPseudoLegalMoveCount]; // The captures are stored from the front and the quiets from the back
             MoveAndScore* m_captureMovesAndScores;
             MoveAndScore* m_badCaptureMovesAndScores; // Note: This array grows backwards.
             MoveAndScore* m_quietMovesAndScores;
-            void m_scoreMoves();
+            MoveList m_moveList; // Only used when the moves are generated by the selector
+            void m_scoreMoves(uint16_t begin, uint16_t end);
+            void m_generateNoisyMoves();
+            void m_generateQuietMoves();
     };
 
 }
\ No newline at end of file
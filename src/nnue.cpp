@@ -1,5 +1,10 @@
 #include <nnue.hpp>
+#include <numa.hpp>
 #include <tuning/nnueformat.hpp>
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <memory>
 
 using namespace Arcanum;
 
@@ -16,9 +21,14 @@ uint16_t NNUE::getFeatureIndex(square_t pieceSquare, Color pieceColor, Piece pie
 }
 
 uint32_t NNUE::getOutputBucket(const Board& board)
+{
+    return getOutputBucket(board.getNumPieces());
+}
+
+uint32_t NNUE::getOutputBucket(uint8_t numPieces)
 {
     constexpr uint32_t Divisor = (32 + NumOutputBuckets - 1) / NumOutputBuckets;
-    return (board.getNumPieces() - 2) / Divisor;
+    return (numPieces - 2) / Divisor;
 }
 
 // Calculate the delta features of the board when performing a move
@@ -99,30 +109,110 @@ void NNUE::findFullFeatureSet(const Board& board, FullFeatureSet& featureSet)
     }
 }
 
+static const char QuantizedMagic[16] = "Arcanum QNNUE";
+static constexpr uint32_t QuantizedVersion = 1;
+
 NNUE::NNUE()
 {
-    m_net = new NNUE::Net();
+    m_allocatedNet = new NNUE::Net();
+    m_net = m_allocatedNet;
+    m_replicas = { m_net };
+    m_instructionSet = Cpu::getInstructionSet();
+    DEBUG("Using " << Cpu::getInstructionSetName(m_instructionSet) << " kernels for the NNUE")
 }
 
 NNUE::~NNUE()
 {
-    delete m_net;
+    m_freeReplicas();
+    delete m_allocatedNet;
+}
+
+void NNUE::m_freeReplicas()
+{
+    for(const Net* replica : m_replicas)
+    {
+        if(replica != m_net)
+        {
+            delete replica;
+        }
+    }
+
+    m_replicas = { m_net };
+}
+
+// Copy the net to each NUMA node, such that the weights are read from local memory
+void NNUE::m_replicateNet()
+{
+    m_freeReplicas();
+
+    uint32_t numNodes = Numa::getNumNodes();
+    if(numNodes <= 1)
+    {
+        return;
+    }
+
+    m_replicas.clear();
+    for(uint32_t node = 0; node < numNodes; node++)
+    {
+        // The replica is allocated and copied by a thread bound to the node,
+        // to place the pages of the replica on the node when they are first touched.
+        const Net* replica = nullptr;
+        std::thread thread([&]{
+            Numa::bindThread(node);
+            replica = new NNUE::Net(*m_net);
+        });
+        thread.join();
+        m_replicas.push_back(replica);
+    }
+
+    DEBUG("Replicated the net to " << numNodes << " NUMA nodes")
+}
+
+// Loads 16 feature transformer weights as 16-bit values
+// The 8-bit weights are sign extended, such that they are added to the 16-bit accumulators
+static inline __m256i loadFTWeights(const int16_t* weights)
+{
+    return _mm256_load_si256((const __m256i*) weights);
+}
+
+static inline __m256i loadFTWeights(const int8_t* weights)
+{
+    return _mm256_cvtepi8_epi16(_mm_load_si128((const __m128i*) weights));
+}
+
+inline const NNUE::Net* NNUE::m_getNet() const
+{
+    if(m_replicas.size() == 1)
+    {
+        return m_net;
+    }
+
+    return m_replicas[Numa::getCurrentNode()];
 }
 
 void NNUE::initializeAccumulator(Accumulator* acc, const Board& board)
 {
+    const Net* net = m_getNet();
     constexpr uint32_t NumChunks = L1Size / 16;
 
     FullFeatureSet featureSet;
     findFullFeatureSet(board, featureSet);
 
+    #ifdef USE_AVX512
+    if(m_instructionSet != Cpu::AVX2)
+    {
+        m_initializeAccumulatorAvx512(acc, featureSet);
+        return;
+    }
+    #endif
+
     __m256i* wacc = (__m256i*) acc->acc[Color::WHITE];
     __m256i* bacc = (__m256i*) acc->acc[Color::BLACK];
 
     for(uint32_t i = 0; i < NumChunks; i++)
     {
-        *(wacc + i) = _mm256_load_si256(((__m256i*) (m_net->ftBiases)) + i);
-        *(bacc + i) = _mm256_load_si256(((__m256i*) (m_net->ftBiases)) + i);
+        *(wacc + i) = _mm256_load_si256(((__m256i*) (net->ftBiases)) + i);
+        *(bacc + i) = _mm256_load_si256(((__m256i*) (net->ftBiases)) + i);
     }
 
     for(uint32_t i = 0; i < featureSet.numFeatures; i++)
@@ -132,8 +222,8 @@ void NNUE::initializeAccumulator(Accumulator* acc, const Board& board)
 
         for(uint32_t j = 0; j < NumChunks; j++)
         {
-            *(wacc + j) = _mm256_add_epi16(*(wacc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[wfindex*L1Size])) + j));
-            *(bacc + j) = _mm256_add_epi16(*(bacc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[bfindex*L1Size])) + j));
+            *(wacc + j) = _mm256_add_epi16(*(wacc + j), loadFTWeights(&net->ftWeights[wfindex*L1Size + 16*j]));
+            *(bacc + j) = _mm256_add_epi16(*(bacc + j), loadFTWeights(&net->ftWeights[bfindex*L1Size + 16*j]));
         }
     }
 }
@@ -141,11 +231,21 @@ void NNUE::initializeAccumulator(Accumulator* acc, const Board& board)
 // The board should be in the state before the move is performed
 void NNUE::incrementAccumulator(Accumulator* acc, Accumulator* nextAcc, const Board& board, const Move& move)
 {
+    const Net* net = m_getNet();
     constexpr uint32_t NumChunks = L1Size / 16;
 
     DeltaFeatures delta;
     findDeltaFeatures(board, move, delta);
 
+    #ifdef USE_AVX512
+    if(m_instructionSet != Cpu::AVX2)
+    {
+        incrementAccumulatorPerspective(acc, nextAcc, delta, Color::WHITE);
+        incrementAccumulatorPerspective(acc, nextAcc, delta, Color::BLACK);
+        return;
+    }
+    #endif
+
     __m256i* wacc = (__m256i*) acc->acc[Color::WHITE];
     __m256i* bacc = (__m256i*) acc->acc[Color::BLACK];
     __m256i* wnextAcc = (__m256i*) nextAcc->acc[Color::WHITE];
@@ -164,8 +264,8 @@ void NNUE::incrementAccumulator(Accumulator* acc, Accumulator* nextAcc, const Bo
         uint32_t bfindex = delta.added[Color::BLACK][i];
         for(uint32_t j = 0; j < NumChunks; j++)
         {
-            *(wnextAcc + j) = _mm256_add_epi16(*(wnextAcc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[wfindex*L1Size])) + j));
-            *(bnextAcc + j) = _mm256_add_epi16(*(bnextAcc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[bfindex*L1Size])) + j));
+            *(wnextAcc + j) = _mm256_add_epi16(*(wnextAcc + j), loadFTWeights(&net->ftWeights[wfindex*L1Size + 16*j]));
+            *(bnextAcc + j) = _mm256_add_epi16(*(bnextAcc + j), loadFTWeights(&net->ftWeights[bfindex*L1Size + 16*j]));
         }
     }
 
@@ -175,8 +275,8 @@ void NNUE::incrementAccumulator(Accumulator* acc, Accumulator* nextAcc, const Bo
         uint32_t bfindex = delta.removed[Color::BLACK][i];
         for(uint32_t j = 0; j < NumChunks; j++)
         {
-            *(wnextAcc + j) = _mm256_sub_epi16(*(wnextAcc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[wfindex*L1Size])) + j));
-            *(bnextAcc + j) = _mm256_sub_epi16(*(bnextAcc + j), _mm256_load_si256(((__m256i*) (&m_net->ftWeights[bfindex*L1Size])) + j));
+            *(wnextAcc + j) = _mm256_sub_epi16(*(wnextAcc + j), loadFTWeights(&net->ftWeights[wfindex*L1Size + 16*j]));
+            *(bnextAcc + j) = _mm256_sub_epi16(*(bnextAcc + j), loadFTWeights(&net->ftWeights[bfindex*L1Size + 16*j]));
         }
     }
 }
@@ -188,12 +288,33 @@ void NNUE::incrementAccumulatorPerspective(Accumulator* acc, Accumulator* nextAc
     switch(funcIndex)
     {
         case 0b0101:
+            #ifdef USE_AVX512
+            if(m_instructionSet != Cpu::AVX2)
+            {
+                m_accUpdateAvx512<1, 1>(acc, nextAcc, deltaFeatures, perspective);
+                break;
+            }
+            #endif
             m_accAddSub(acc, nextAcc, deltaFeatures, perspective);
             break;
         case 0b1001:
+            #ifdef USE_AVX512
+            if(m_instructionSet != Cpu::AVX2)
+            {
+                m_accUpdateAvx512<1, 2>(acc, nextAcc, deltaFeatures, perspective);
+                break;
+            }
+            #endif
             m_accAddSubSub(acc, nextAcc, deltaFeatures, perspective);
             break;
         case 0b1010:
+            #ifdef USE_AVX512
+            if(m_instructionSet != Cpu::AVX2)
+            {
+                m_accUpdateAvx512<2, 2>(acc, nextAcc, deltaFeatures, perspective);
+                break;
+            }
+            #endif
             m_accAddAddSubSub(acc, nextAcc, deltaFeatures, perspective);
             break;
         default:
@@ -203,82 +324,105 @@ void NNUE::incrementAccumulatorPerspective(Accumulator* acc, Accumulator* nextAc
 
 void NNUE::m_accAddSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective)
 {
+    const Net* net = m_getNet();
     constexpr uint32_t NumChunks = L1Size / 16;
 
     __m256i* acc256     = (__m256i*) acc->acc[perspective];
     __m256i* nextAcc256 = (__m256i*) nextAcc->acc[perspective];
 
-    __m256i* ftAddBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.added[perspective][0]*L1Size]));
-    __m256i* ftSubBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size]));
+    const ftweight_t* ftAddBase0 = &net->ftWeights[deltaFeatures.added[perspective][0]*L1Size];
+    const ftweight_t* ftSubBase0 = &net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size];
 
     for(uint32_t i = 0; i < NumChunks; i++)
     {
         // Copy from the old accumulator to the new accumulator and add the first feature.
-        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), _mm256_load_si256(ftAddBase0 + i));
+        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), loadFTWeights(ftAddBase0 + 16*i));
         // Subtract
-        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), _mm256_load_si256(ftSubBase0 + i));
+        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), loadFTWeights(ftSubBase0 + 16*i));
     }
 }
 
 void NNUE::m_accAddSubSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective)
 {
+    const Net* net = m_getNet();
     constexpr uint32_t NumChunks = L1Size / 16;
 
     __m256i* acc256     = (__m256i*) acc->acc[perspective];
     __m256i* nextAcc256 = (__m256i*) nextAcc->acc[perspective];
 
-    __m256i* ftAddBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.added[perspective][0]*L1Size]));
-    __m256i* ftSubBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size]));
-    __m256i* ftSubBase1 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.removed[perspective][1]*L1Size]));
+    const ftweight_t* ftAddBase0 = &net->ftWeights[deltaFeatures.added[perspective][0]*L1Size];
+    const ftweight_t* ftSubBase0 = &net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size];
+    const ftweight_t* ftSubBase1 = &net->ftWeights[deltaFeatures.removed[perspective][1]*L1Size];
 
     for(uint32_t i = 0; i < NumChunks; i++)
     {
         // Copy from the old accumulator to the new accumulator and add the first feature.
-        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), _mm256_load_si256(ftAddBase0 + i));
+        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), loadFTWeights(ftAddBase0 + 16*i));
         // Subtract
-        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), _mm256_load_si256(ftSubBase0 + i));
+        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), loadFTWeights(ftSubBase0 + 16*i));
         // Subtract
-        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), _mm256_load_si256(ftSubBase1 + i));
+        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), loadFTWeights(ftSubBase1 + 16*i));
     }
 }
 
 void NNUE::m_accAddAddSubSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective)
 {
+    const Net* net = m_getNet();
     constexpr uint32_t NumChunks = L1Size / 16;
 
     __m256i* acc256     = (__m256i*) acc->acc[perspective];
     __m256i* nextAcc256 = (__m256i*) nextAcc->acc[perspective];
 
-    __m256i* ftAddBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.added[perspective][0]*L1Size]));
-    __m256i* ftAddBase1 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.added[perspective][1]*L1Size]));
-    __m256i* ftSubBase0 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size]));
-    __m256i* ftSubBase1 = ((__m256i*) (&m_net->ftWeights[deltaFeatures.removed[perspective][1]*L1Size]));
+    const ftweight_t* ftAddBase0 = &net->ftWeights[deltaFeatures.added[perspective][0]*L1Size];
+    const ftweight_t* ftAddBase1 = &net->ftWeights[deltaFeatures.added[perspective][1]*L1Size];
+    const ftweight_t* ftSubBase0 = &net->ftWeights[deltaFeatures.removed[perspective][0]*L1Size];
+    const ftweight_t* ftSubBase1 = &net->ftWeights[deltaFeatures.removed[perspective][1]*L1Size];
 
     for(uint32_t i = 0; i < NumChunks; i++)
     {
         // Copy from the old accumulator to the new accumulator and add the first feature.
-        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), _mm256_load_si256(ftAddBase0 + i));
+        *(nextAcc256 + i) = _mm256_add_epi16(*(acc256 + i), loadFTWeights(ftAddBase0 + 16*i));
         // Add
-        *(nextAcc256 + i) = _mm256_add_epi16(*(nextAcc256 + i), _mm256_load_si256(ftAddBase1 + i));
+        *(nextAcc256 + i) = _mm256_add_epi16(*(nextAcc256 + i), loadFTWeights(ftAddBase1 + 16*i));
         // Subtract
-        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), _mm256_load_si256(ftSubBase0 + i));
+        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), loadFTWeights(ftSubBase0 + 16*i));
         // Subtract
-        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), _mm256_load_si256(ftSubBase1 + i));
+        *(nextAcc256 + i) = _mm256_sub_epi16(*(nextAcc256 + i), loadFTWeights(ftSubBase1 + 16*i));
     }
 }
 
-eval_t NNUE::predict(const Accumulator* acc, const Board& board)
+// Adds all the 32-bit values in the vector
+static inline int32_t horizontalSum(__m256i v)
 {
-    alignas(64) uint8_t clampedAcc[L1Size];
-    alignas(64) int32_t l1Out[1];
+    __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b01001110)); // Swap the 64-bit halves
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0b10110001)); // Swap the 32-bit pairs
+    return _mm_cvtsi128_si32(sum128);
+}
 
+eval_t NNUE::predict(const Accumulator* acc, const Board& board)
+{
+    const Net* net = m_getNet();
     uint32_t bucket = getOutputBucket(board);
+    const int16_t* in = acc->acc[board.getTurn()];
+    int32_t l1Out;
 
-    m_clampAcc(acc->acc[board.getTurn()], clampedAcc);
-
-    m_l1AffineTransform(clampedAcc, m_net->l1Weights[bucket], m_net->l1Biases[bucket], l1Out);
+    #ifdef USE_AVX512
+    if(m_instructionSet == Cpu::AVX512_VNNI)
+    {
+        l1Out = m_clampedL1AffineTransformAvx512Vnni(in, net->l1Weights[bucket], net->l1Biases[bucket][0]);
+    }
+    else if(m_instructionSet == Cpu::AVX512)
+    {
+        l1Out = m_clampedL1AffineTransformAvx512(in, net->l1Weights[bucket], net->l1Biases[bucket][0]);
+    }
+    else
+    #endif
+    {
+        l1Out = m_clampedL1AffineTransform(in, net->l1Weights[bucket], net->l1Biases[bucket][0]);
+    }
 
-    return *l1Out * NetworkScale / (FTQ * LQ);
+    return l1Out * NetworkScale / (FTQ * LQ);
 }
 
 eval_t NNUE::predictBoard(const Board& board)
@@ -288,14 +432,110 @@ eval_t NNUE::predictBoard(const Board& board)
     return predict(&acc, board);
 }
 
-inline void NNUE::m_clampAcc(const int16_t* in, uint8_t* out)
+void NNUE::predictBatch(const Accumulator* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, uint32_t numChildren, Color perspective, eval_t* out)
 {
-    constexpr uint32_t NumChunks = L1Size / 16;
+    alignas(64) int32_t l1Out[MaxBatchSize];
+
+    // The number of children is a template argument, such that the sums of all the children are kept in registers
+    switch(numChildren)
+    {
+        case 1: m_predictBatch<1>(acc->acc[perspective], deltaFeatures, buckets, perspective, l1Out); break;
+        case 2: m_predictBatch<2>(acc->acc[perspective], deltaFeatures, buckets, perspective, l1Out); break;
+        case 3: m_predictBatch<3>(acc->acc[perspective], deltaFeatures, buckets, perspective, l1Out); break;
+        case 4: m_predictBatch<4>(acc->acc[perspective], deltaFeatures, buckets, perspective, l1Out); break;
+        default:
+            ERROR("Unsupported batch size: " << numChildren)
+            return;
+    }
+
+    for(uint32_t i = 0; i < numChildren; i++)
+    {
+        out[i] = l1Out[i] * NetworkScale / (FTQ * LQ);
+    }
+}
 
-    const __m256i* in256 = (__m256i*) in;
-    __m256i* out256 = (__m256i*) out;
+// Calculates each chunk of the children from the parent, and multiplies it with the output layer while it is in registers.
+// The bytes are clamped and paired like in m_clampedL1AffineTransform, so the result is identical to predict.
+// AVX-512 CPUs without VNNI also use this kernel, as it saturates like their predict kernel.
+template <uint32_t NumChildren>
+void NNUE::m_predictBatch(const int16_t* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, Color perspective, int32_t* out)
+{
+    #ifdef USE_AVX512
+    if(m_instructionSet == Cpu::AVX512_VNNI)
+    {
+        m_predictBatchAvx512Vnni<NumChildren>(acc, deltaFeatures, buckets, perspective, out);
+        return;
+    }
+    #endif
+
+    const Net* net = m_getNet();
+    constexpr uint32_t NumChunks = L1Size / 32;
+
+    const __m256i* acc256 = (const __m256i*) acc;
+    const ftweight_t* added[NumChildren][2];
+    const ftweight_t* removed[NumChildren][2];
+    const __m256i* weights[NumChildren];
+    __m256i sums[NumChildren];
+
+    for(uint32_t k = 0; k < NumChildren; k++)
+    {
+        for(uint32_t j = 0; j < deltaFeatures[k].numAdded; j++)
+        {
+            added[k][j] = &net->ftWeights[deltaFeatures[k].added[perspective][j]*L1Size];
+        }
+        for(uint32_t j = 0; j < deltaFeatures[k].numRemoved; j++)
+        {
+            removed[k][j] = &net->ftWeights[deltaFeatures[k].removed[perspective][j]*L1Size];
+        }
+        weights[k] = (const __m256i*) net->l1Weights[buckets[k]];
+        sums[k] = _mm256_setzero_si256();
+    }
 
-    for(uint32_t i = 0; i < NumChunks / 2; i++)
+    const __m256i ones = _mm256_set1_epi16(1);
+    for(uint32_t i = 0; i < NumChunks; i++)
+    {
+        __m256i parent1 = _mm256_load_si256(acc256 + 2*i);
+        __m256i parent2 = _mm256_load_si256(acc256 + 2*i + 1);
+
+        for(uint32_t k = 0; k < NumChildren; k++)
+        {
+            __m256i child1 = parent1;
+            __m256i child2 = parent2;
+            for(uint32_t j = 0; j < deltaFeatures[k].numAdded; j++)
+            {
+                child1 = _mm256_add_epi16(child1, loadFTWeights(added[k][j] + 32*i));
+                child2 = _mm256_add_epi16(child2, loadFTWeights(added[k][j] + 32*i + 16));
+            }
+            for(uint32_t j = 0; j < deltaFeatures[k].numRemoved; j++)
+            {
+                child1 = _mm256_sub_epi16(child1, loadFTWeights(removed[k][j] + 32*i));
+                child2 = _mm256_sub_epi16(child2, loadFTWeights(removed[k][j] + 32*i + 16));
+            }
+
+            __m256i clamped = _mm256_permute4x64_epi64(_mm256_packus_epi16(child1, child2), 0b11011000);
+            __m256i sum16 = _mm256_maddubs_epi16(clamped, _mm256_load_si256(weights[k] + i));
+            sums[k] = _mm256_add_epi32(sums[k], _mm256_madd_epi16(sum16, ones));
+        }
+    }
+
+    for(uint32_t k = 0; k < NumChildren; k++)
+    {
+        out[k] = horizontalSum(sums[k]) + net->l1Biases[buckets[k]][0];
+    }
+}
+
+// Clamps the accumulator and multiplies it with the output layer in one pass, without storing the clamped values
+inline int32_t NNUE::m_clampedL1AffineTransform(const int16_t* in, const int8_t* weights, int32_t bias)
+{
+    constexpr uint32_t NumChunks = L1Size / 32;
+
+    const __m256i* in256 = (const __m256i*) in;
+    const __m256i* w256  = (const __m256i*) weights;
+    const __m256i ones   = _mm256_set1_epi16(1);
+
+    __m256i acc = _mm256_setzero_si256();
+
+    for(uint32_t i = 0; i < NumChunks; i++)
     {
         __m256i acc1 = _mm256_load_si256(in256 + 2*i);
         __m256i acc2 = _mm256_load_si256(in256 + 2*i + 1);
@@ -312,60 +552,346 @@ inline void NNUE::m_clampAcc(const int16_t* in, uint8_t* out)
         constexpr uint8_t select = 0b11011000; // 0, 2, 1, 3 (LSB first)
         acc8bit = _mm256_permute4x64_epi64(acc8bit, select);
 
-        _mm256_store_si256(out256 + i, acc8bit);
+        // Note: The first argument is treated as unsigned bytes, and the second as signed bytes
+        __m256i sum16 = _mm256_maddubs_epi16(acc8bit, _mm256_load_si256(w256 + i));
+
+        // Add the adjacent 16-bit sums as 32-bit values
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(sum16, ones));
     }
+
+    return horizontalSum(acc) + bias;
 }
 
-inline void NNUE::m_l1AffineTransform(const uint8_t* in, int8_t* weights, int32_t* biases, int32_t* out)
+#ifdef USE_AVX512
+// GCC 12 warns about the intentionally undefined values used inside the AVX-512 intrinsic headers
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+// Loads 32 feature transformer weights as 16-bit values
+TARGET_AVX512 static inline __m512i loadFTWeightsAvx512(const int16_t* weights)
 {
-    constexpr uint32_t NumInChunks  = L1Size / 32;
+    return _mm512_load_si512(weights);
+}
 
-    __m256i* in256  = (__m256i*) in;
-    __m256i* w256   = (__m256i*) weights;
+TARGET_AVX512 static inline __m512i loadFTWeightsAvx512(const int8_t* weights)
+{
+    return _mm512_cvtepi8_epi16(_mm256_load_si256((const __m256i*) weights));
+}
 
-    __m256i acc = _mm256_setzero_si256();
+TARGET_AVX512 void NNUE::m_initializeAccumulatorAvx512(Accumulator* acc, const FullFeatureSet& featureSet)
+{
+    const Net* net = m_getNet();
+    constexpr uint32_t NumChunks = L1Size / 32;
+
+    __m512i* wacc = (__m512i*) acc->acc[Color::WHITE];
+    __m512i* bacc = (__m512i*) acc->acc[Color::BLACK];
+    const __m512i* biases = (const __m512i*) net->ftBiases;
 
-    for(uint32_t j = 0; j < NumInChunks; j++)
+    // Each chunk is kept in a register while all the features are added
+    for(uint32_t j = 0; j < NumChunks; j++)
     {
-        __m256i factors8 = _mm256_load_si256(in256 + j);
-        __m256i weights8 = _mm256_load_si256(w256 + j);
+        __m512i wsum = _mm512_load_si512(biases + j);
+        __m512i bsum = wsum;
 
-        // Note: The first argument is treated as unsigned bytes, and the second as signed bytes
-        __m256i sum16 = _mm256_maddubs_epi16(factors8, weights8);
+        for(uint32_t i = 0; i < featureSet.numFeatures; i++)
+        {
+            const ftweight_t* wweights = &net->ftWeights[featureSet.features[Color::WHITE][i]*L1Size];
+            const ftweight_t* bweights = &net->ftWeights[featureSet.features[Color::BLACK][i]*L1Size];
+            wsum = _mm512_add_epi16(wsum, loadFTWeightsAvx512(wweights + 32*j));
+            bsum = _mm512_add_epi16(bsum, loadFTWeightsAvx512(bweights + 32*j));
+        }
+
+        _mm512_store_si512(wacc + j, wsum);
+        _mm512_store_si512(bacc + j, bsum);
+    }
+}
+
+template <uint32_t NumAdded, uint32_t NumRemoved>
+TARGET_AVX512 void NNUE::m_accUpdateAvx512(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective)
+{
+    const Net* net = m_getNet();
+    constexpr uint32_t NumChunks = L1Size / 32;
+
+    const __m512i* acc512 = (const __m512i*) acc->acc[perspective];
+    __m512i* nextAcc512   = (__m512i*) nextAcc->acc[perspective];
+
+    const ftweight_t* ftAddBase[NumAdded];
+    const ftweight_t* ftSubBase[NumRemoved];
+    for(uint32_t i = 0; i < NumAdded; i++)
+    {
+        ftAddBase[i] = &net->ftWeights[deltaFeatures.added[perspective][i]*L1Size];
+    }
+    for(uint32_t i = 0; i < NumRemoved; i++)
+    {
+        ftSubBase[i] = &net->ftWeights[deltaFeatures.removed[perspective][i]*L1Size];
+    }
+
+    for(uint32_t j = 0; j < NumChunks; j++)
+    {
+        __m512i sum = _mm512_load_si512(acc512 + j);
+        for(uint32_t i = 0; i < NumAdded; i++)
+        {
+            sum = _mm512_add_epi16(sum, loadFTWeightsAvx512(ftAddBase[i] + 32*j));
+        }
+        for(uint32_t i = 0; i < NumRemoved; i++)
+        {
+            sum = _mm512_sub_epi16(sum, loadFTWeightsAvx512(ftSubBase[i] + 32*j));
+        }
+        _mm512_store_si512(nextAcc512 + j, sum);
+    }
+}
+
+// Gives the same result as the AVX2 kernel, including the saturation of _mm512_maddubs_epi16
+TARGET_AVX512 int32_t NNUE::m_clampedL1AffineTransformAvx512(const int16_t* in, const int8_t* weights, int32_t bias)
+{
+    constexpr uint32_t NumChunks = L1Size / 64;
+
+    const __m512i* in512 = (const __m512i*) in;
+    const __m512i* w512  = (const __m512i*) weights;
+    const __m512i ones   = _mm512_set1_epi16(1);
+
+    // _mm512_packus_epi16 interleaves the two inputs per 128-bit lane: [a0, b0, a1, b1, a2, b2, a3, b3]
+    // The 64-bit chunks are moved back into order [a0, a1, a2, a3, b0, b1, b2, b3]
+    const __m512i unshuffle = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+
+    __m512i acc = _mm512_setzero_si512();
+
+    for(uint32_t i = 0; i < NumChunks; i++)
+    {
+        static_assert(FTQ == 255, "Adjust clamping when FTQ is changed");
+        __m512i acc8bit = _mm512_packus_epi16(_mm512_load_si512(in512 + 2*i), _mm512_load_si512(in512 + 2*i + 1));
+        acc8bit = _mm512_permutexvar_epi64(unshuffle, acc8bit);
+
+        __m512i sum16 = _mm512_maddubs_epi16(acc8bit, _mm512_load_si512(w512 + i));
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(sum16, ones));
+    }
+
+    return _mm512_reduce_add_epi32(acc) + bias;
+}
+
+// vpdpbusd multiplies the unsigned and signed bytes and accumulates them directly in 32-bit,
+// so it does not saturate the intermediate 16-bit sums like _mm256_maddubs_epi16
+TARGET_AVX512_VNNI int32_t NNUE::m_clampedL1AffineTransformAvx512Vnni(const int16_t* in, const int8_t* weights, int32_t bias)
+{
+    constexpr uint32_t NumChunks = L1Size / 64;
+
+    const __m512i* in512 = (const __m512i*) in;
+    const __m512i* w512  = (const __m512i*) weights;
+    const __m512i unshuffle = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+
+    // vpdpbusd has a high latency, so independent sums are used to avoid waiting for the previous chunk
+    constexpr uint32_t NumSums = 4;
+    static_assert(NumChunks % NumSums == 0, "The chunks have to be divisible between the sums");
+    __m512i sums[NumSums];
+    for(uint32_t j = 0; j < NumSums; j++)
+    {
+        sums[j] = _mm512_setzero_si512();
+    }
+
+    for(uint32_t i = 0; i < NumChunks; i += NumSums)
+    {
+        for(uint32_t j = 0; j < NumSums; j++)
+        {
+            __m512i acc8bit = _mm512_packus_epi16(_mm512_load_si512(in512 + 2*(i + j)), _mm512_load_si512(in512 + 2*(i + j) + 1));
+            acc8bit = _mm512_permutexvar_epi64(unshuffle, acc8bit);
+            sums[j] = _mm512_dpbusd_epi32(sums[j], acc8bit, _mm512_load_si512(w512 + i + j));
+        }
+    }
+
+    __m512i acc = _mm512_add_epi32(_mm512_add_epi32(sums[0], sums[1]), _mm512_add_epi32(sums[2], sums[3]));
+    return _mm512_reduce_add_epi32(acc) + bias;
+}
+
+template <uint32_t NumChildren>
+TARGET_AVX512_VNNI void NNUE::m_predictBatchAvx512Vnni(const int16_t* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, Color perspective, int32_t* out)
+{
+    const Net* net = m_getNet();
+    constexpr uint32_t NumChunks = L1Size / 64;
+
+    const __m512i* acc512 = (const __m512i*) acc;
+    const ftweight_t* added[NumChildren][2];
+    const ftweight_t* removed[NumChildren][2];
+    const __m512i* weights[NumChildren];
+    __m512i sums[NumChildren];
 
-        // Extract the upper and lower part of the 16-bit vectors and convert them to 32-bit
-        __m256i sum32_1 = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(sum16, 0));
-        __m256i sum32_2 = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(sum16, 1));
+    for(uint32_t k = 0; k < NumChildren; k++)
+    {
+        for(uint32_t j = 0; j < deltaFeatures[k].numAdded; j++)
+        {
+            added[k][j] = &net->ftWeights[deltaFeatures[k].added[perspective][j]*L1Size];
+        }
+        for(uint32_t j = 0; j < deltaFeatures[k].numRemoved; j++)
+        {
+            removed[k][j] = &net->ftWeights[deltaFeatures[k].removed[perspective][j]*L1Size];
+        }
+        weights[k] = (const __m512i*) net->l1Weights[buckets[k]];
+        sums[k] = _mm512_setzero_si512();
+    }
+
+    const __m512i unshuffle = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    for(uint32_t i = 0; i < NumChunks; i++)
+    {
+        __m512i parent1 = _mm512_load_si512(acc512 + 2*i);
+        __m512i parent2 = _mm512_load_si512(acc512 + 2*i + 1);
+
+        for(uint32_t k = 0; k < NumChildren; k++)
+        {
+            __m512i child1 = parent1;
+            __m512i child2 = parent2;
+            for(uint32_t j = 0; j < deltaFeatures[k].numAdded; j++)
+            {
+                child1 = _mm512_add_epi16(child1, loadFTWeightsAvx512(added[k][j] + 64*i));
+                child2 = _mm512_add_epi16(child2, loadFTWeightsAvx512(added[k][j] + 64*i + 32));
+            }
+            for(uint32_t j = 0; j < deltaFeatures[k].numRemoved; j++)
+            {
+                child1 = _mm512_sub_epi16(child1, loadFTWeightsAvx512(removed[k][j] + 64*i));
+                child2 = _mm512_sub_epi16(child2, loadFTWeightsAvx512(removed[k][j] + 64*i + 32));
+            }
+
+            __m512i clamped = _mm512_permutexvar_epi64(unshuffle, _mm512_packus_epi16(child1, child2));
+            sums[k] = _mm512_dpbusd_epi32(sums[k], clamped, _mm512_load_si512(weights[k] + i));
+        }
+    }
+
+    for(uint32_t k = 0; k < NumChildren; k++)
+    {
+        out[k] = _mm512_reduce_add_epi32(sums[k]) + net->l1Biases[buckets[k]][0];
+    }
+}
+
+#pragma GCC diagnostic pop
+#endif
 
-        acc = _mm256_add_epi32(acc, _mm256_add_epi32(sum32_1, sum32_2));
+bool NNUE::load(const std::string filename)
+{
+    NNUEFile file;
+    if(!file.open(filename))
+    {
+        return false;
+    }
+
+    bool isQuantized = (file.size() >= sizeof(QuantizedHeader)) && (std::memcmp(file.data(), QuantizedMagic, sizeof(QuantizedMagic)) == 0);
+    bool loaded = isQuantized ? m_loadQuantized(file, filename) : m_loadFloat(filename);
+    if(loaded)
+    {
+        m_replicateNet();
     }
 
-    // Horizontally add all the 32-bit values in the acc vector
-    // Two sums will accumulate in acc[0] and acc[4] where acc is a 32-bit array
-    acc = _mm256_hadd_epi32(acc, acc);
-    acc = _mm256_hadd_epi32(acc, acc);
-    int32_t* acc32 = (int32_t*) &acc;
-    *out = acc32[0] + acc32[4] + biases[0];
+    return loaded;
 }
 
-void NNUE::load(const std::string filename)
+bool NNUE::m_loadFloat(const std::string& filename)
 {
     NNUEParser parser;
     if(!parser.load(filename))
     {
-        return;
+        return false;
     }
 
+    // Quantize into a new net, such that the current net is kept if the quantization fails
+    std::unique_ptr<Net> net(new NNUE::Net());
+
     // Quantize the featuretransformer
-    parser.read(m_net->ftWeights, L1Size, FTSize, FTQ);
-    parser.read(m_net->ftBiases,  L1Size,      1, FTQ);
+    bool status = true;
+    status &= parser.read(net->ftWeights, L1Size, FTSize, FTQ);
+    status &= parser.read(net->ftBiases,  L1Size,      1, FTQ);
 
     // Quantize the output layers with buckets
     for(uint32_t i = 0; i < NumOutputBuckets; i++)
     {
-        parser.readTranspose(m_net->l1Weights[i], 1, L1Size, LQ);
-        parser.read(m_net->l1Biases[i], 1, 1, LQ * FTQ);
+        status &= parser.readTranspose(net->l1Weights[i], 1, L1Size, LQ);
+        status &= parser.read(net->l1Biases[i], 1, 1, LQ * FTQ);
     }
 
+    // A net with weights outside the quantized range would give wrong evals
+    if(!status)
+    {
+        ERROR("Failed to quantize " << filename << ", the net has to be trained with the weights clamped to the quantized range")
+        return false;
+    }
+
+    m_freeReplicas();
+    delete m_allocatedNet;
+    m_allocatedNet = net.release();
+    m_net = m_allocatedNet;
+    m_replicas = { m_net };
+    m_file.close();
+
     DEBUG("Finished loading and quantizing: " << filename)
+    return true;
+}
+
+bool NNUE::m_loadQuantized(NNUEFile& file, const std::string& filename)
+{
+    QuantizedHeader header;
+    std::memcpy(&header, file.data(), sizeof(QuantizedHeader));
+
+    if((header.version != QuantizedVersion)
+    || (header.ftSize != FTSize)
+    || (header.l1Size != L1Size)
+    || (header.numOutputBuckets != NumOutputBuckets)
+    || (header.ftq != FTQ)
+    || (header.lq != LQ)
+    || (header.netSize != sizeof(Net))
+    || (file.size() < sizeof(QuantizedHeader) + sizeof(Net)))
+    {
+        ERROR("The quantized net " << filename << " does not match the architecture. Version: " << header.version << " Size: " << file.size())
+        return false;
+    }
+
+    m_freeReplicas();
+    const Net* net = reinterpret_cast<const Net*>(file.data() + sizeof(QuantizedHeader));
+    if(reinterpret_cast<uintptr_t>(net) % alignof(Net) == 0)
+    {
+        // The weights are used directly from the mapped file or the embedded net
+        delete m_allocatedNet;
+        m_allocatedNet = nullptr;
+        m_net = net;
+        m_file = std::move(file);
+    }
+    else
+    {
+        if(m_allocatedNet == nullptr)
+        {
+            m_allocatedNet = new NNUE::Net();
+        }
+
+        std::memcpy(m_allocatedNet, net, sizeof(Net));
+        m_net = m_allocatedNet;
+        m_file.close();
+    }
+    m_replicas = { m_net };
+
+    DEBUG("Finished loading quantized net: " << filename)
+    return true;
+}
+
+// Writes the net in the quantized format, which can be loaded without quantizing or copying the weights
+bool NNUE::storeQuantized(const std::string& filename) const
+{
+    std::string path = getWorkPath() + filename;
+    std::ofstream ofs(path, std::ios::out | std::ios::binary);
+    if(!ofs)
+    {
+        ERROR("Unable to open " << path)
+        return false;
+    }
+
+    QuantizedHeader header = {};
+    std::memcpy(header.magic, QuantizedMagic, sizeof(QuantizedMagic));
+    header.version = QuantizedVersion;
+    header.ftSize = FTSize;
+    header.l1Size = L1Size;
+    header.numOutputBuckets = NumOutputBuckets;
+    header.ftq = FTQ;
+    header.lq = LQ;
+    header.netSize = sizeof(Net);
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(QuantizedHeader));
+    ofs.write(reinterpret_cast<const char*>(m_net), sizeof(Net));
+    ofs.close();
+
+    INFO("Finished writing quantized NNUE to " << path)
+    return true;
 }
@@ -2,6 +2,16 @@
 
 #include <types.hpp>
 #include <board.hpp>
+#include <cpu.hpp>
+#include <tuning/nnueformat.hpp>
+#include <vector>
+
+#ifdef USE_AVX512
+// The AVX-512 kernels are compiled for their own target, such that the rest of the build only requires AVX2.
+// They are only called when the CPU supports them.
+#define TARGET_AVX512      __attribute__((target("avx512f,avx512bw")))
+#define TARGET_AVX512_VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+#endif
 
 namespace Arcanum
 {
@@ -15,6 +25,15 @@ namespace Arcanum
             static constexpr int32_t FTQ = 255; // Quantization factor of the feature transformer
             static constexpr int32_t LQ = 64;   // Quantization factor of the linear layers
             static constexpr uint32_t NumOutputBuckets = 1;
+            static constexpr uint32_t MaxBatchSize = 4; // Maximum number of children in predictBatch
+
+            // The feature transformer weights can be quantized to 8-bit to halve the memory read by the accumulator updates
+            // This requires a net trained with the weights clamped to the 8-bit range
+            #ifdef ENABLE_INT8_FT
+            typedef int8_t ftweight_t;
+            #else
+            typedef int16_t ftweight_t;
+            #endif
 
             struct Accumulator
             {
@@ -25,12 +44,28 @@ namespace Arcanum
             // except the l1Weights which are transposed during loading
             struct Net
             {
-                alignas(64) int16_t ftWeights[L1Size * FTSize];
+                alignas(64) ftweight_t ftWeights[L1Size * FTSize];
                 alignas(64) int16_t ftBiases[L1Size];
                 alignas(64) int8_t  l1Weights[NumOutputBuckets][1 * L1Size];
                 alignas(64) int32_t l1Biases[NumOutputBuckets][1];
             };
 
+            // Header of the quantized net file, which is followed by the Net exactly as it is stored in memory
+            // The header is padded such that the net is aligned when the file is mapped
+            struct QuantizedHeader
+            {
+                char magic[16];
+                uint32_t version;
+                uint32_t ftSize;
+                uint32_t l1Size;
+                uint32_t numOutputBuckets;
+                int32_t ftq;
+                int32_t lq;
+                uint32_t netSize;
+                uint8_t padding[20];
+            };
+            static_assert(sizeof(QuantizedHeader) == 64);
+
             struct DeltaFeatures
             {
                 uint8_t numAdded;
@@ -52,25 +87,51 @@ namespace Arcanum
             };
 
             static uint32_t getOutputBucket(const Board& board);
+            static uint32_t getOutputBucket(uint8_t numPieces);
             static uint16_t getFeatureIndex(square_t pieceSquare, Color pieceColor, Piece pieceType, Color perspective);
             static void findDeltaFeatures(const Board& board, const Move& move, DeltaFeatures& delta);
             static void findFullFeatureSet(const Board& board, FullFeatureSet& featureSet);
 
             NNUE();
             ~NNUE();
-            void load(const std::string filename);
+            // Loads a float net which is quantized, or a quantized net which is used without copying it
+            bool load(const std::string filename);
+            bool storeQuantized(const std::string& filename) const;
             void initializeAccumulator(Accumulator* acc, const Board& board);
             void incrementAccumulator(Accumulator* acc, Accumulator* nextAcc, const Board& board, const Move& move);
             void incrementAccumulatorPerspective(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective);
             eval_t predict(const Accumulator* acc, const Board& board);
             eval_t predictBoard(const Board& board);
+            // Predicts the children of the position of the accumulator, each given by its delta features and output bucket.
+            // The parent is read once for all the children, and the accumulators of the children are not stored.
+            // The perspective is the side to move in the children, and has to be updated in the accumulator.
+            void predictBatch(const Accumulator* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, uint32_t numChildren, Color perspective, eval_t* out);
         private:
-            Net* m_net;
+            const Net* m_net;
+            Net* m_allocatedNet;   // Used for quantizing float nets, null when a quantized net is used in place
+            NNUEFile m_file;       // The file of the quantized net used in place
+            std::vector<const Net*> m_replicas; // One copy of the net per NUMA node
+            Cpu::InstructionSet m_instructionSet; // Selects the kernels at runtime
+            bool m_loadFloat(const std::string& filename);
+            bool m_loadQuantized(NNUEFile& file, const std::string& filename);
+            void m_replicateNet();
+            void m_freeReplicas();
+            const Net* m_getNet() const;
             void m_accAddSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective);
             void m_accAddSubSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective);
             void m_accAddAddSubSub(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective);
-            void m_l1AffineTransform(const uint8_t* in, int8_t* weights, int32_t* biases, int32_t* out);
-            void m_clampAcc(const int16_t* in, uint8_t* out);
+            int32_t m_clampedL1AffineTransform(const int16_t* in, const int8_t* weights, int32_t bias);
+            template <uint32_t NumChildren>
+            void m_predictBatch(const int16_t* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, Color perspective, int32_t* out);
+            #ifdef USE_AVX512
+            TARGET_AVX512 void m_initializeAccumulatorAvx512(Accumulator* acc, const FullFeatureSet& featureSet);
+            template <uint32_t NumAdded, uint32_t NumRemoved>
+            TARGET_AVX512 void m_accUpdateAvx512(Accumulator* acc, Accumulator* nextAcc, const DeltaFeatures& deltaFeatures, Color perspective);
+            TARGET_AVX512 int32_t m_clampedL1AffineTransformAvx512(const int16_t* in, const int8_t* weights, int32_t bias);
+            TARGET_AVX512_VNNI int32_t m_clampedL1AffineTransformAvx512Vnni(const int16_t* in, const int8_t* weights, int32_t bias);
+            template <uint32_t NumChildren>
+            TARGET_AVX512_VNNI void m_predictBatchAvx512Vnni(const int16_t* acc, const DeltaFeatures* deltaFeatures, const uint32_t* buckets, Color perspective, int32_t* out);
+            #endif
     };
 
 }
\ No newline at end of file
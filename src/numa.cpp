@@ -0,0 +1,120 @@
+#include <numa.hpp>
+#include <utils.hpp>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+using namespace Arcanum;
+
+thread_local uint32_t Numa::m_currentNode = 0;
+
+// Parses a cpulist on the format "0-15,32-47"
+static std::vector<uint32_t> parseCpuList(const std::string& str)
+{
+    std::vector<uint32_t> cpus;
+    std::stringstream ss(str);
+    std::string range;
+
+    while(std::getline(ss, range, ','))
+    {
+        if(range.empty())
+        {
+            continue;
+        }
+
+        size_t dash = range.find('-');
+        uint32_t first = std::stoul(range.substr(0, dash));
+        uint32_t last  = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+
+        for(uint32_t cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+Numa::Topology::Topology()
+{
+    #if defined(__linux__)
+    for(uint32_t node = 0;; node++)
+    {
+        std::ifstream stream("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if(!stream.is_open())
+        {
+            break;
+        }
+
+        std::string cpuList;
+        std::getline(stream, cpuList);
+        std::vector<uint32_t> cpus = parseCpuList(cpuList);
+
+        // Nodes with only memory are not used for binding threads
+        if(!cpus.empty())
+        {
+            nodeCpus.push_back(cpus);
+        }
+    }
+    #endif
+
+    // Fallback to a single node
+    if(nodeCpus.empty())
+    {
+        nodeCpus.push_back({});
+    }
+
+    DEBUG("Found " << nodeCpus.size() << " NUMA node(s)")
+}
+
+const Numa::Topology& Numa::m_getTopology()
+{
+    static const Topology topology;
+    return topology;
+}
+
+uint32_t Numa::getNumNodes()
+{
+    return m_getTopology().nodeCpus.size();
+}
+
+uint32_t Numa::getNodeForThread(uint32_t threadIndex)
+{
+    return threadIndex % getNumNodes();
+}
+
+void Numa::bindThread(uint32_t node)
+{
+    const Topology& topology = m_getTopology();
+
+    // Do not override the affinity given by the user if there is nothing to gain
+    if(topology.nodeCpus.size() <= 1 || node >= topology.nodeCpus.size())
+    {
+        return;
+    }
+
+    #if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(uint32_t cpu : topology.nodeCpus[node])
+    {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    if(sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0)
+    {
+        WARNING("Failed to bind thread to NUMA node " << node)
+        return;
+    }
+    #endif
+
+    m_currentNode = node;
+}
+
+uint32_t Numa::getCurrentNode()
+{
+    return m_currentNode;
+}
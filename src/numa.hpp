@@ -0,0 +1,31 @@
+#pragma once
+
+#include <types.hpp>
+#include <vector>
+
+namespace Arcanum
+{
+    // NUMA topology found by parsing /sys/devices/system/node on Linux.
+    // On other platforms, or if only one node exists, all threads are assumed to be on node 0,
+    // and binding threads has no effect.
+    class Numa
+    {
+        private:
+            struct Topology
+            {
+                std::vector<std::vector<uint32_t>> nodeCpus;
+                Topology();
+            };
+
+            static thread_local uint32_t m_currentNode;
+            static const Topology& m_getTopology();
+        public:
+            static uint32_t getNumNodes();
+            // Returns the node the thread with the given index should be bound to
+            static uint32_t getNodeForThread(uint32_t threadIndex);
+            // Binds the calling thread to the cpus of the given node
+            static void bindThread(uint32_t node);
+            // Returns the node the calling thread is bound to
+            static uint32_t getCurrentNode();
+    };
+}
@@ -4,26 +4,30 @@ using namespace Arcanum;
 
 uint64_t Arcanum::findNumMovesAtDepth(Board& board, uint32_t depth)
 {
-    Move* legalMoves = board.getLegalMoves();
-    uint8_t numLegalMoves = board.getNumLegalMoves();
+    // Bulk count the moves at the leaves
+    if(depth == 1)
+    {
+        return board.countLegalMoves();
+    }
+
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    uint8_t numLegalMoves = legalMoves.size;
 
     if(numLegalMoves == 0)
     {
         return 0LL;
     }
 
-    if(depth == 1)
-    {
-        return numLegalMoves;
-    }
+    board.generateCaptureInfo(legalMoves);
 
     uint64_t total = 0LL;
-    board.generateCaptureInfo();
+    UndoRecord undo;
     for(int i = 0; i < numLegalMoves; i++)
     {
-        Board newBoard = Board(board);
-        newBoard.performMove(legalMoves[i]);
-        total += findNumMovesAtDepth(newBoard, depth - 1);
+        board.makeMove(legalMoves[i], undo);
+        total += findNumMovesAtDepth(board, depth - 1);
+        board.unmakeMove(legalMoves[i], undo);
     }
 
     return total;
@@ -32,8 +36,11 @@ uint64_t Arcanum::findNumMovesAtDepth(Board& board, uint32_t depth)
 void Arcanum::perft(Board& board, uint32_t depth)
 {
     uint64_t count = 0LL;
-    Move* legalMoves = board.getLegalMoves();
-    uint8_t numLegalMoves = board.getNumLegalMoves();
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    board.generateCaptureInfo(legalMoves);
+    uint8_t numLegalMoves = legalMoves.size;
+    UndoRecord undo;
 
     for(uint8_t i = 0; i < numLegalMoves; i++)
     {
@@ -45,9 +52,9 @@ void Arcanum::perft(Board& board, uint32_t depth)
         }
         else
         {
-            Board newBoard = Board(board);
-            newBoard.performMove(legalMoves[i]);
-            localCount = findNumMovesAtDepth(newBoard, depth - 1);
+            board.makeMove(legalMoves[i], undo);
+            localCount = findNumMovesAtDepth(board, depth - 1);
+            board.unmakeMove(legalMoves[i], undo);
         }
 
         count += localCount;
@@ -15,6 +15,12 @@ PvTable::PvTable(uint32_t maxPvLength) : m_maxPvLength(maxPvLength)
     memset(m_pvTable, 0, sizeof(Move) * maxPvLength * maxPvLength);
 };
 
+PvTable::~PvTable()
+{
+    delete[] m_pvLengths;
+    delete[] m_pvTable;
+}
+
 inline uint32_t PvTable::m_tableIndex(uint32_t plyFromRoot, uint32_t ply) const
 {
     return plyFromRoot * m_maxPvLength + ply;
@@ -46,6 +52,22 @@ std::string PvTable::getPvLine()
     return str;
 }
 
+// Returns the move at the given ply in the PV-line from the root, or a null move if the line is too short
+Move PvTable::getPvMove(uint8_t ply) const
+{
+    if(ply >= m_pvLengths[0])
+    {
+        return NULL_MOVE;
+    }
+
+    return m_pvTable[m_tableIndex(0, ply)];
+}
+
+uint8_t PvTable::getPvLength() const
+{
+    return m_pvLengths[0];
+}
+
 void PvTable::updatePvLength(uint8_t plyFromRoot)
 {
     if(plyFromRoot >= m_maxPvLength)
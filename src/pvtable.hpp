@@ -14,8 +14,13 @@ namespace Arcanum
             uint32_t m_tableIndex(uint32_t plyFromRoot, uint32_t ply) const;
         public:
             PvTable(uint32_t maxPvLength);
+            ~PvTable();
+            PvTable(const PvTable&) = delete;
+            PvTable& operator=(const PvTable&) = delete;
             void updatePv(const Move& move, uint8_t plyFromRoot);
             void updatePvLength(uint8_t plyFromRoot);
             std::string getPvLine();
+            Move getPvMove(uint8_t ply) const;
+            uint8_t getPvLength() const;
     };
 }
\ No newline at end of file
@@ -2,27 +2,92 @@
 #include <uci/uci.hpp>
 #include <utils.hpp>
 #include <syzygy.hpp>
+#include <zobrist.hpp>
+#include <numa.hpp>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 using namespace Arcanum;
 
 #define DRAW_VALUE 0
 
-Searcher::Searcher(bool verbose) :
-m_tt(TranspositionTable()),
-m_pvTable(PvTable(MaxSearchPly)),
+Searcher::Searcher(bool verbose) : Searcher(verbose, nullptr)
+{}
+
+// Helper searchers are created with the TT of the main searcher
+Searcher::Searcher(bool verbose, TranspositionTable* sharedTT) :
+m_numHistoryPlies(0),
+m_tt(sharedTT),
+m_isHelper(sharedTT != nullptr),
+m_helperSearching(false),
+m_helperExit(false),
 m_stats(SearchStats()),
-m_verbose(verbose)
+m_verbose(verbose),
+m_stopSearch(false),
+m_isPondering(false),
+m_ponderhitPending(false),
+m_clockRunning(false),
+m_clockExit(false),
+m_clockThreadExit(false),
+m_bestMove(NULL_MOVE),
+m_bestScore(0),
+m_bestDepth(0)
 {
+    if(!m_isHelper)
+    {
+        m_tt = new TranspositionTable();
+        ASSERT_OR_EXIT(m_tt != nullptr, "Failed to allocate memory for the transposition table")
+    }
+
     m_lmrReductions = new uint8_t[MaxSearchDepth * MaxMoveCount];
     ASSERT_OR_EXIT(m_lmrReductions != nullptr, "Failed to allocate memory for LMR reductions")
 
+    m_pvTables.push_back(new PvTable(MaxSearchPly));
+    m_pvTable = m_pvTables[0];
+
     m_initializeTables();
 }
 
 Searcher::~Searcher()
 {
+    for(Searcher* helper : m_helpers)
+    {
+        delete helper;
+    }
+
+    if(m_helperThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_helperMutex);
+            m_helperExit = true;
+        }
+
+        m_helperCondition.notify_all();
+        m_helperThread.join();
+    }
+
+    if(m_clockThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_clockMutex);
+            m_clockThreadExit = true;
+        }
+
+        m_clockCondition.notify_all();
+        m_clockThread.join();
+    }
+
+    if(!m_isHelper)
+    {
+        delete m_tt;
+    }
+
+    for(PvTable* pvTable : m_pvTables)
+    {
+        delete pvTable;
+    }
+
     delete[] m_lmrReductions;
 }
 
@@ -66,13 +131,41 @@ void Searcher::setVerbose(bool enable)
 
 void Searcher::resizeTT(uint32_t mbSize)
 {
-    m_tt.resize(mbSize);
+    m_tt->resize(mbSize);
+}
+
+void Searcher::setNumThreads(uint32_t numThreads)
+{
+    // The main searcher counts as one of the threads
+    uint32_t numHelpers = std::max(numThreads, 1u) - 1;
+
+    while(m_helpers.size() > numHelpers)
+    {
+        delete m_helpers.back();
+        m_helpers.pop_back();
+    }
+
+    while(m_helpers.size() < numHelpers)
+    {
+        // The main thread is thread 0
+        Searcher* helper = new Searcher(false, m_tt);
+        uint32_t node = Numa::getNodeForThread(m_helpers.size() + 1);
+        helper->m_helperThread = std::thread(&Searcher::m_runHelper, helper, node);
+        m_helpers.push_back(helper);
+    }
+
+    DEBUG("Using " << m_helpers.size() + 1 << " search threads")
 }
 
 void Searcher::clear()
 {
-    m_tt.clear();
+    m_tt->clear();
     m_heuristics.clear();
+
+    for(Searcher* helper : m_helpers)
+    {
+        helper->m_heuristics.clear();
+    }
 }
 
 eval_t Searcher::m_adjustEval(eval_t rawEval, Board& board)
@@ -86,6 +179,28 @@ eval_t Searcher::m_adjustEval(eval_t rawEval, Board& board)
     return Evaluator::clampEval(adjustedEval);
 }
 
+// Returns the next move of the quiescence search which passes SEE and is legal, or nullptr when there are no more moves
+const Move* Searcher::m_getNextQSearchMove(MoveSelector& moveSelector, Board& board, bool isChecked)
+{
+    while(const Move *move = moveSelector.getNextMove())
+    {
+        if(!isChecked && !move->isPromotion() && !board.see(*move))
+        {
+            m_stats.quietSeeCuts++;
+            continue;
+        }
+
+        if(!board.isLegal(*move))
+        {
+            continue;
+        }
+
+        return move;
+    }
+
+    return nullptr;
+}
+
 template <bool isPv>
 eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int plyFromRoot)
 {
@@ -94,12 +209,12 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
         return 0;
     }
 
-    m_numNodesSearched++;
+    m_countNode();
     m_stats.qSearchNodes++;
 
     if constexpr (isPv)
     {
-        m_pvTable.updatePvLength(plyFromRoot);
+        m_pvTable->updatePvLength(plyFromRoot);
         m_seldepth = std::max(m_seldepth, uint8_t(plyFromRoot));
         m_stats.pvNodes++;
     }
@@ -113,14 +228,24 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
         return DRAW_VALUE;
     }
 
+    // The side to move can at least draw if it can repeat a previous position
+    if(alpha < DRAW_VALUE && m_hasUpcomingRepetition(board, plyFromRoot))
+    {
+        alpha = DRAW_VALUE;
+        if(alpha >= beta)
+        {
+            return alpha;
+        }
+    }
+
     eval_t bestScore = -Evaluator::MateScore;
 
-    std::optional<TTEntry> entry = m_tt.get(board.getHash(), plyFromRoot);
+    std::optional<TTEntry> entry = m_tt->get(board.getHash(), plyFromRoot);
     Move ttMove = NULL_MOVE;
     if(entry.has_value())
     {
         PackedMove packedMove = entry->getPackedMove();
-        ttMove = board.generateMoveWithInfo(packedMove.from(), packedMove.to(), packedMove.promotionInfo());
+        ttMove = board.decodeTTMove(packedMove);
     }
 
     if(!isPv && entry.has_value())
@@ -156,7 +281,7 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
     else
     {
         m_stats.evaluations++;
-        rawEval = m_evaluator.evaluate(board, plyFromRoot);
+        rawEval = m_evaluator.evaluate(board);
     }
 
     eval_t staticEval = m_adjustEval(rawEval, board);
@@ -179,11 +304,14 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
     }
 
     // Genereate only capture moves if not in check, else generate all moves
-    Move *moves = board.getLegalCaptureMoves();
-    uint8_t numMoves = board.getNumLegalMoves();
+    // The captures are pseudo-legal, and legality is only checked for the moves which are searched
+    // When in check, all legal evasions are generated, thus no moves means checkmate
+    MoveList moves;
+    board.generatePseudoLegalCaptureMoves(moves);
+    uint16_t numMoves = moves.size;
     if(numMoves == 0)
     {
-        return staticEval;
+        return isChecked ? Evaluator::getTerminalScore(isChecked, plyFromRoot) : staticEval;
     }
 
     // Push the board on the search stack
@@ -191,24 +319,65 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
     m_searchStacks.staticEvals[plyFromRoot] = staticEval;
     m_searchStacks.moves      [plyFromRoot] = NULL_MOVE;
 
-    board.generateCaptureInfo();
-    MoveSelector moveSelector = MoveSelector(moves, numMoves, plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
+    board.generateCaptureInfo(moves);
+
+    UndoRecord undo;
+    MoveSelector moveSelector = MoveSelector(moves.moves, numMoves, plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
     TTFlag ttFlag = TTFlag::UPPER_BOUND;
     Move bestMove = NULL_MOVE;
-    while(const Move *move = moveSelector.getNextMove())
+
+    // The first move is searched alone, as it often causes a cutoff.
+    // If it does not, the remaining moves are likely to be searched, and their stand-pat evals are found in batches.
+    const Move* batch[NNUE::MaxBatchSize];
+    eval_t batchEvals[NNUE::MaxBatchSize];
+    uint8_t batchSize = 0;
+    uint8_t batchIndex = 0;
+    uint8_t maxBatchSize = 1;
+    while(true)
     {
-        if(!isChecked && !move->isPromotion() && !board.see(*move))
+        if(batchIndex == batchSize)
         {
-            m_stats.quietSeeCuts++;
-            continue;
+            batchIndex = 0;
+            batchSize = 0;
+            while(batchSize < maxBatchSize)
+            {
+                const Move* nextMove = m_getNextQSearchMove(moveSelector, board, isChecked);
+                if(nextMove == nullptr)
+                {
+                    break;
+                }
+                batch[batchSize++] = nextMove;
+            }
+
+            if(batchSize == 0)
+            {
+                break;
+            }
+
+            if(batchSize > 1)
+            {
+                m_evaluator.evaluateMoves(board, batch, batchSize, batchEvals);
+                m_stats.batchedEvaluations += batchSize;
+            }
+            maxBatchSize = NNUE::MaxBatchSize;
         }
 
-        Board newBoard = Board(board);
-        newBoard.performMove(*move);
-        m_tt.prefetch(newBoard.getHash());
-        m_evaluator.pushMoveToAccumulator(board, *move);
+        const Move* move = batch[batchIndex];
+        if(batchSize > 1)
+        {
+            m_evaluator.pushMoveToAccumulator(board, *move, batchEvals[batchIndex]);
+        }
+        else
+        {
+            m_evaluator.pushMoveToAccumulator(board, *move);
+        }
+        batchIndex++;
+
+        board.makeMove(*move, undo);
+        m_tt->prefetch(board.getHash());
         m_searchStacks.moves[plyFromRoot] = *move;
-        eval_t score = -m_alphaBetaQuiet<isPv>(newBoard, -beta, -alpha, plyFromRoot + 1);
+        eval_t score = -m_alphaBetaQuiet<isPv>(board, -beta, -alpha, plyFromRoot + 1);
+        board.unmakeMove(*move, undo);
         m_evaluator.popMoveFromAccumulator();
 
         if(score > bestScore)
@@ -221,7 +390,7 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
         {
             if constexpr(isPv)
             {
-                m_pvTable.updatePv(*move, plyFromRoot);
+                m_pvTable->updatePv(*move, plyFromRoot);
                 ttFlag = TTFlag::EXACT;
             }
             alpha = score;
@@ -243,7 +412,7 @@ eval_t Searcher::m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int p
         return 0;
     }
 
-    m_tt.add(bestScore, bestMove, isPv, 0, plyFromRoot, rawEval, ttFlag, board.getHash());
+    m_tt->add(bestScore, bestMove, isPv, 0, plyFromRoot, rawEval, ttFlag, board.getHash());
 
     return bestScore;
 }
@@ -261,10 +430,10 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         return 0;
     }
 
-    m_numNodesSearched++;
+    m_countNode();
     if constexpr (isPv)
     {
-        m_pvTable.updatePvLength(plyFromRoot);
+        m_pvTable->updatePvLength(plyFromRoot);
         m_seldepth = std::max(m_seldepth, uint8_t(plyFromRoot));
         m_stats.pvNodes++;
     }
@@ -278,6 +447,16 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         return DRAW_VALUE;
     }
 
+    // The side to move can at least draw if it can repeat a previous position
+    if(alpha < DRAW_VALUE && m_hasUpcomingRepetition(board, plyFromRoot))
+    {
+        alpha = DRAW_VALUE;
+        if(alpha >= beta)
+        {
+            return alpha;
+        }
+    }
+
     // Mate distance pruning
     alpha = std::max(alpha, eval_t(plyFromRoot - Evaluator::MateScore));
     beta = std::min(beta, eval_t(Evaluator::MateScore - plyFromRoot - 1));
@@ -290,12 +469,12 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
     eval_t bestScore = -Evaluator::MateScore;
     eval_t maxScore = Evaluator::MateScore;
 
-    std::optional<TTEntry> entry = m_tt.get(board.getHash(), plyFromRoot);
+    std::optional<TTEntry> entry = m_tt->get(board.getHash(), plyFromRoot);
     Move ttMove = NULL_MOVE;
     if(entry.has_value())
     {
         PackedMove packedMove = entry->getPackedMove();
-        ttMove = board.generateMoveWithInfo(packedMove.from(), packedMove.to(), packedMove.promotionInfo());
+        ttMove = board.decodeTTMove(packedMove);
     }
 
     if(!isPv && entry.has_value() && (entry->depth >= depth) && skipMove.isNull())
@@ -328,7 +507,7 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
 
         if(tbResult != Syzygy::WDLResult::FAILED)
         {
-            m_tbHits++;
+            m_tbHits.store(m_tbHits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
             eval_t tbScore;
             TTFlag tbFlag;
 
@@ -352,8 +531,8 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
                 // Use a somewhat higher depth for the TB score in the TT,
                 // Both to give it priority and to make it useful for following iterations
                 uint8_t tbDepth = std::min(uint8_t(depth + 6), uint8_t(MaxSearchDepth));
-                eval_t rawEval = m_evaluator.evaluate(board, plyFromRoot);
-                m_tt.add(tbScore, NULL_MOVE, isPv, tbDepth, plyFromRoot, rawEval, tbFlag, board.getHash());
+                eval_t rawEval = m_evaluator.evaluate(board);
+                m_tt->add(tbScore, NULL_MOVE, isPv, tbDepth, plyFromRoot, rawEval, tbFlag, board.getHash());
                 return tbScore;
             }
 
@@ -372,11 +551,6 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
     m_heuristics.killerManager.clearPly(plyFromRoot + 1);
 
     Move bestMove = NULL_MOVE;
-    Move* moves = nullptr;
-    uint8_t numMoves = 0;
-
-    moves = board.getLegalMoves();
-    numMoves = board.getNumLegalMoves();
 
     eval_t rawEval;
     if(entry.has_value())
@@ -386,17 +560,12 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
     else
     {
         m_stats.evaluations++;
-        rawEval = m_evaluator.evaluate(board, plyFromRoot);
+        rawEval = m_evaluator.evaluate(board);
     }
 
     eval_t staticEval = m_adjustEval(rawEval, board);
 
-    if(numMoves == 0)
-    {
-        return skipMove.isNull() ? staticEval : alpha;
-    }
-
-    board.generateCaptureInfo();
+    UndoRecord undo;
     bool isChecked = board.isChecked();
     bool isImproving = (plyFromRoot > 1) && (staticEval > m_searchStacks.staticEvals[plyFromRoot - 2]);
     bool isWorsening = (plyFromRoot > 1) && (staticEval < m_searchStacks.staticEvals[plyFromRoot - 2]);
@@ -426,8 +595,7 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         {
             if(staticEval + 200 * depth < alpha)
             {
-                Board newBoard = Board(board);
-                eval_t razorEval = m_alphaBetaQuiet<false>(newBoard, alpha, beta, plyFromRoot);
+                eval_t razorEval = m_alphaBetaQuiet<false>(board, alpha, beta, plyFromRoot);
                 if(razorEval <= alpha)
                 {
                     m_stats.razorCutoffs++;
@@ -440,12 +608,12 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         // Null move search
         if(depth > 2 && !isNullMoveSearch && staticEval >= beta && !Evaluator::isMateScore(beta) && board.hasOfficers(board.getTurn()))
         {
-            Board newBoard = Board(board);
             int R = 4 + isImproving + depth / 4;
-            newBoard.performNullMove();
-            m_tt.prefetch(newBoard.getHash());
+            board.makeNullMove(undo);
+            m_tt->prefetch(board.getHash());
             m_searchStacks.moves[plyFromRoot] = NULL_MOVE;
-            eval_t nullMoveScore = -m_alphaBeta<false>(newBoard, -beta, -beta + 1, depth - R, plyFromRoot + 1, !cutnode, totalExtensions);
+            eval_t nullMoveScore = -m_alphaBeta<false>(board, -beta, -beta + 1, depth - R, plyFromRoot + 1, !cutnode, totalExtensions);
+            board.unmakeNullMove(undo);
 
             if(nullMoveScore >= beta)
             {
@@ -461,30 +629,30 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         && !Evaluator::isMateScore(beta)
         && (!entry.has_value() || (entry->depth < depth - 3) || entry->eval >= probBeta))
         {
-            MoveSelector moveSelector = MoveSelector(moves, numMoves, plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
-            moveSelector.skipQuiets(); // Note: Killers and counters are still included
+            MoveSelector moveSelector = MoveSelector(plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
+            moveSelector.skipQuiets(); // Note: The quiet moves are not generated
             while(const Move* move = moveSelector.getNextMove())
             {
-                if(!board.see(*move, 1))
+                if(!board.see(*move, 1) || !board.isLegal(*move))
                 {
                     continue;
                 }
 
-                Board newBoard = Board(board);
-                newBoard.performMove(*move);
-                m_tt.prefetch(newBoard.getHash());
                 m_evaluator.pushMoveToAccumulator(board, *move);
+                board.makeMove(*move, undo);
+                m_tt->prefetch(board.getHash());
                 m_searchStacks.moves[plyFromRoot] = *move;
 
                 m_stats.probCutQSearches++;
-                eval_t score = -m_alphaBetaQuiet<false>(newBoard, -probBeta, -probBeta + 1, plyFromRoot + 1);
+                eval_t score = -m_alphaBetaQuiet<false>(board, -probBeta, -probBeta + 1, plyFromRoot + 1);
 
                 if(score >= probBeta)
                 {
                     m_stats.probCutSearches++;
-                    score = -m_alphaBeta<false>(newBoard, -probBeta, -probBeta + 1, depth - 4, plyFromRoot + 1, cutnode, totalExtensions);
+                    score = -m_alphaBeta<false>(board, -probBeta, -probBeta + 1, depth - 4, plyFromRoot + 1, cutnode, totalExtensions);
                 }
 
+                board.unmakeMove(*move, undo);
                 m_evaluator.popMoveFromAccumulator();
 
                 if(score >= probBeta)
@@ -497,19 +665,22 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         }
     }
 
-    MoveSelector moveSelector = MoveSelector(moves, numMoves, plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
+    MoveSelector moveSelector = MoveSelector(plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
     uint8_t quietMovesPerformed = 0;
     uint8_t captureMovesPerformed = 0;
     Move performedMoves[MaxMoveCount];
     uint32_t moveNumber = 0;
+    uint8_t numLegalMoves = 0;
 
     while (const Move* move = moveSelector.getNextMove())
     {
-        if(*move == skipMove)
+        if((*move == skipMove) || !board.isLegal(*move))
         {
             continue;
         }
 
+        numLegalMoves++;
+
         int32_t historyScore = 0;
         if(move->isQuiet())
         {
@@ -573,20 +744,16 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
             }
         }
 
-        // Generate new board and make the move
-        Board newBoard = Board(board);
-        newBoard.performMove(*move);
-        m_tt.prefetch(newBoard.getHash());
         eval_t score;
 
         // Extend search when only a single move is available
-        uint8_t extension = (numMoves == 1);
+        // The number of moves is only known when in check, as all evasions are generated at once
+        uint8_t extension = isChecked && (moveSelector.getNumMoves() == 1);
 
         // Singular extension
         if(
             skipMove.isNull()
             && extension == 0
-            && numMoves > 1
             && depth >= 7
             && entry.has_value()
             && ttMove == *move
@@ -618,7 +785,11 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
             extension = 0;
         }
 
+        // Make the move
+        const Color turn = board.getTurn();
         m_evaluator.pushMoveToAccumulator(board, *move);
+        board.makeMove(*move, undo);
+        m_tt->prefetch(board.getHash());
         m_searchStacks.moves[plyFromRoot] = *move;
 
         int32_t newDepth = depth + extension - 1;
@@ -626,7 +797,7 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
 
         if(moveNumber == 0)
         {
-            score = -m_alphaBeta<isPv>(newBoard, -beta, -alpha, newDepth, plyFromRoot + 1, !(isPv | cutnode), newTotalExtensions);
+            score = -m_alphaBeta<isPv>(board, -beta, -alpha, newDepth, plyFromRoot + 1, !(isPv | cutnode), newTotalExtensions);
         }
         else
         {
@@ -636,9 +807,9 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
             {
                 R =  m_getReduction(depth, moveNumber);
                 R += isWorsening;
-                R -= newBoard.isChecked();
+                R -= board.isChecked();
                 R -= m_heuristics.killerManager.contains(*move, plyFromRoot);
-                R -= m_heuristics.counterManager.contains(*move, prevMove, board.getTurn());
+                R -= m_heuristics.counterManager.contains(*move, prevMove, turn);
                 R -= historyScore / 8000;
                 R += cutnode;
                 R -= isPv;
@@ -647,24 +818,25 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
 
             int32_t reducedDepth = newDepth - R;
 
-            score = -m_alphaBeta<false>(newBoard, -alpha - 1, -alpha, reducedDepth, plyFromRoot + 1, !cutnode, newTotalExtensions);
+            score = -m_alphaBeta<false>(board, -alpha - 1, -alpha, reducedDepth, plyFromRoot + 1, !cutnode, newTotalExtensions);
             m_stats.researchesRequired += score > alpha && (isPv || newDepth > reducedDepth);
             m_stats.nullWindowSearches += 1;
 
             // Potential research of LMR returns a score > alpha
             if(score > alpha && newDepth > reducedDepth)
             {
-                score = -m_alphaBeta<false>(newBoard, -alpha - 1, -alpha, newDepth, plyFromRoot + 1, !cutnode, newTotalExtensions);
+                score = -m_alphaBeta<false>(board, -alpha - 1, -alpha, newDepth, plyFromRoot + 1, !cutnode, newTotalExtensions);
                 m_stats.researchesRequired += score > alpha && isPv;
                 m_stats.nullWindowSearches += 1;
             }
 
             if(score > alpha && isPv)
             {
-                score = -m_alphaBeta<isPv>(newBoard, -beta, -alpha, newDepth, plyFromRoot + 1, false, newTotalExtensions);
+                score = -m_alphaBeta<isPv>(board, -beta, -alpha, newDepth, plyFromRoot + 1, false, newTotalExtensions);
             }
         }
 
+        board.unmakeMove(*move, undo);
         m_evaluator.popMoveFromAccumulator();
 
         if(score > alpha)
@@ -672,7 +844,7 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
             alpha = score;
             if constexpr(isPv)
             {
-                m_pvTable.updatePv(*move, plyFromRoot);
+                m_pvTable->updatePv(*move, plyFromRoot);
             }
         }
 
@@ -727,6 +899,13 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         return 0;
     }
 
+    // Checkmate and stalemate are detected from the number of legal moves, as the moves are only generated by the move selector
+    // All moves are checked for legality before they are pruned, thus no legal moves means there are none
+    if(numLegalMoves == 0)
+    {
+        return skipMove.isNull() ? Evaluator::getTerminalScore(isChecked, plyFromRoot) : alpha;
+    }
+
     bestScore = std::min(bestScore, maxScore);
 
     if(skipMove.isNull())
@@ -735,7 +914,7 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
         if(bestScore <= originalAlpha) flag = TTFlag::UPPER_BOUND;
         else if(bestScore >= beta)     flag = TTFlag::LOWER_BOUND;
 
-        m_tt.add(bestScore, bestMove, isPv, depth, plyFromRoot, rawEval, flag, board.getHash());
+        m_tt->add(bestScore, bestMove, isPv, depth, plyFromRoot, rawEval, flag, board.getHash());
 
         if (!board.isChecked() && !bestMove.isCapture() && ((flag == TTFlag::EXACT) || (flag == (bestScore >= staticEval ? TTFlag::LOWER_BOUND : TTFlag::UPPER_BOUND)))) {
             m_heuristics.correctionHistory.update(board, bestScore, staticEval, depth);
@@ -745,266 +924,1093 @@ eval_t Searcher::m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth,
     return bestScore;
 }
 
-inline bool Searcher::m_isDraw(const Board& board, uint8_t plyFromRoot) const
+// Bounded-depth search which only proves mates within the given depth.
+// Only exact pruning is used, such that a mate within the depth is never missed.
+// Positions without a proven mate are scored as draws, which is outside the mate window of the root.
+eval_t Searcher::m_alphaBetaMate(Board& board, eval_t alpha, eval_t beta, int depth, int plyFromRoot)
 {
-    // Check for repeated positions in the current search
-    // * Only check for boards backwards until captures occur (halfMoves)
-    // * Only check every other board, as the turn has to be correct
-    const uint16_t limit = std::min(uint16_t(plyFromRoot), board.getHalfMoves());
-    for(uint16_t i = 2; i <= limit; i += 2)
+    if(m_shouldStop())
     {
-        if(m_searchStacks.hashes[plyFromRoot - i] == board.getHash())
-            return true;
+        return 0;
     }
 
-    // Check for repeated positions from previous searches
-    auto globalSearchIt = m_gameHistory.find(board.getHash());
-    if((globalSearchIt != m_gameHistory.end()) && (globalSearchIt->second >= 2))
-    {
-        return true;
-    }
+    m_countNode();
+    m_pvTable->updatePvLength(plyFromRoot);
+    m_seldepth = std::max(m_seldepth, uint8_t(plyFromRoot));
 
-    // Check for 50 move rule
-    if(board.getHalfMoves() >= 100)
+    // Only checkmates can be proven at the horizon
+    if(depth <= 0)
     {
-        return true;
-    }
-
-    // Check material draw
-    return board.isMaterialDraw();
-}
+        if(board.isChecked() && !board.hasLegalMove())
+        {
+            return -Evaluator::MateScore + plyFromRoot;
+        }
 
-Move Searcher::search(Board board, SearchParameters parameters, SearchResult* searchResult)
-{
-    eval_t searchScore = 0;
-    Move searchBestMove = NULL_MOVE;
+        return DRAW_VALUE;
+    }
 
-    m_tbHits = 0;
-    m_stopSearch = false;
-    m_numNodesSearched = 0;
-    m_parameters = parameters;
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    uint8_t numMoves = moves.size;
 
-    // Clamp the search depth to valid values
-    if(!m_parameters.useDepth)
+    if(numMoves == 0)
     {
-        m_parameters.depth = MaxSearchDepth - 1;
+        return Evaluator::getTerminalScore(board.isChecked(), plyFromRoot);
     }
-    m_parameters.depth = std::clamp(m_parameters.depth, 1u, MaxSearchDepth - 1);
-
-    m_tt.incrementGeneration();
-    m_timer.start();
 
-    // Copy the search moves from the parameters
-    Move* moves = m_parameters.searchMoves;
-    uint8_t numMoves = m_parameters.numSearchMoves;
+    if(m_isDraw(board, plyFromRoot))
+    {
+        return DRAW_VALUE;
+    }
 
-    // Only generate moves or probe tablebase if no search moves are provided
-    Syzygy::WDLResult tbResult = Syzygy::WDLResult::FAILED;
-    if(numMoves == 0)
+    // The side to move can at least draw if it can repeat a previous position
+    if(alpha < DRAW_VALUE && m_hasUpcomingRepetition(board, plyFromRoot))
     {
-        tbResult = Syzygy::TBProbeDTZ(board, moves, numMoves);
-        if(tbResult == Syzygy::WDLResult::FAILED)
+        alpha = DRAW_VALUE;
+        if(alpha >= beta)
         {
-            moves = board.getLegalMoves();
-            numMoves = board.getNumLegalMoves();
-            board.generateCaptureInfo();
+            return alpha;
         }
     }
 
-    m_evaluator.initAccumulatorStack(board);
-    eval_t rawEval = m_evaluator.evaluate(board, 0);
-    eval_t staticEval = m_adjustEval(rawEval, board);
+    // Mate distance pruning
+    alpha = std::max(alpha, eval_t(plyFromRoot - Evaluator::MateScore));
+    beta = std::min(beta, eval_t(Evaluator::MateScore - plyFromRoot - 1));
+    if (alpha >= beta)
+    {
+        return alpha;
+    }
 
-    // Initialize the search stack by pushing the initial board
-    m_searchStacks.hashes[0]      = board.getHash();
-    m_searchStacks.staticEvals[0] = staticEval;
-    m_searchStacks.moves[0]       = NULL_MOVE;
+    eval_t originalAlpha = alpha;
 
-    for(uint32_t depth = 1; depth <= m_parameters.depth; depth++)
+    // A mate found by any search is a proof that the side to move can mate at least that fast, which is valid at any depth.
+    // Exact scores and upper bounds are not used, as they might claim a too long mate when the normal search pruned the shorter mate.
+    // Other scores in the TT are only used for move ordering, as they might come from searches with unsound pruning.
+    std::optional<TTEntry> entry = m_tt->get(board.getHash(), plyFromRoot);
+    Move ttMove = NULL_MOVE;
+    if(entry.has_value())
     {
-        m_rootDepth = depth;
-        Move bestMove = NULL_MOVE;
-        eval_t alpha = -Evaluator::MateScore;
-        eval_t beta = Evaluator::MateScore;
-        eval_t aspirationWindowAlpha = 35;
-        eval_t aspirationWindowBeta  = 35;
+        PackedMove packedMove = entry->getPackedMove();
+        ttMove = board.decodeTTMove(packedMove);
 
-        bool rerun = true;
-        while(rerun && !m_shouldStop())
+        if(Evaluator::isRealMateScore(entry->eval) && (entry->getTTFlag() == TTFlag::LOWER_BOUND) && (entry->eval >= beta))
         {
-            rerun = false;
-            m_seldepth = 0;
-            bestMove = NULL_MOVE;
-
-            // The local variable for the best move from the previous iteration is used by the move selector.
-            // This is in case the move from the transposition is not 'correct' due to a miss.
-            // Misses can happen if the position cannot replace another position
-            // This is required to allow using results of incomplete searches
-            MoveSelector moveSelector = MoveSelector(moves, numMoves, 0, &m_heuristics, &board, searchBestMove, m_searchStacks.moves);
-
-            // Aspiration window
-            // Stop using aspiration if the search score or window size is too high
-            bool useAspAlpha = depth > 5 && std::abs(searchScore) < 900 && aspirationWindowAlpha < 600;
-            bool useAspBeta  = depth > 5 && std::abs(searchScore) < 900 && aspirationWindowBeta < 600;
-            alpha = useAspAlpha ? (searchScore - aspirationWindowAlpha) : -Evaluator::MateScore;
-            beta  = useAspBeta  ? (searchScore + aspirationWindowBeta ) : Evaluator::MateScore;
+            m_stats.lowerTTValuesUsed++;
+            return entry->eval;
+        }
+    }
 
-            m_heuristics.killerManager.clearPly(1);
+    m_heuristics.killerManager.clearPly(plyFromRoot + 1);
 
-            for (int i = 0; i < numMoves; i++)
-            {
-                const Move *move = moveSelector.getNextMove();
-                Board newBoard = Board(board);
-                newBoard.performMove(*move);
-                m_tt.prefetch(newBoard.getHash());
-                m_evaluator.pushMoveToAccumulator(board, *move);
-                m_searchStacks.moves[0] = *move;
+    m_searchStacks.hashes[plyFromRoot] = board.getHash();
+    m_searchStacks.moves [plyFromRoot] = NULL_MOVE;
 
-                eval_t score;
-                if(i == 0)
-                {
-                    score = -m_alphaBeta<true>(newBoard, -beta, -alpha, depth - 1, 1, false, 0);
-
-                    // Aspiration window
-                    // Check if the score is lower than alpha for the first move
-                    if(useAspAlpha && score <= alpha)
-                    {
-                        rerun = true;
-                        aspirationWindowAlpha += aspirationWindowAlpha;
-                        m_evaluator.popMoveFromAccumulator();
-                        m_stats.aspirationAlphaFails++;
-                        break;
-                    }
-                }
-                else
-                {
-                    score = -m_alphaBeta<false>(newBoard, -alpha - 1, -alpha, depth - 1, 1, true, 0);
+    board.generateCaptureInfo(moves);
 
-                    if(score > alpha)
-                    {
-                        score = -m_alphaBeta<true>(newBoard, -beta, -alpha, depth - 1, 1, false, 0);
-                    }
-                }
+    UndoRecord undo;
+    MoveSelector moveSelector = MoveSelector(moves.moves, numMoves, plyFromRoot, &m_heuristics, &board, ttMove, m_searchStacks.moves);
+    eval_t bestScore = -Evaluator::MateScore;
+    Move bestMove = NULL_MOVE;
 
-                m_evaluator.popMoveFromAccumulator();
+    while(const Move* move = moveSelector.getNextMove())
+    {
+        m_evaluator.pushMoveToAccumulator(board, *move);
+        board.makeMove(*move, undo);
 
-                if(m_shouldStop())
-                {
-                    break;
-                }
+        // With a single ply left, only moves giving check can mate
+        if(depth == 1 && !board.isChecked())
+        {
+            board.unmakeMove(*move, undo);
+            m_evaluator.popMoveFromAccumulator();
+            bestScore = std::max(bestScore, eval_t(DRAW_VALUE));
+            continue;
+        }
 
-                // Check if the score was outside the aspiration window
-                // It is important to break before the best move is assigned,
-                // to avoid returning a move which is outside the window when search is stopped
-                if(useAspBeta && (score >= beta))
-                {
-                    rerun = true;
-                    aspirationWindowBeta += aspirationWindowBeta;
-                    m_stats.aspirationBetaFails++;
-                    break;
-                }
+        m_tt->prefetch(board.getHash());
+        m_searchStacks.moves[plyFromRoot] = *move;
+        eval_t score = -m_alphaBetaMate(board, -beta, -alpha, depth - 1, plyFromRoot + 1);
+        board.unmakeMove(*move, undo);
+        m_evaluator.popMoveFromAccumulator();
 
-                if(score > alpha)
-                {
-                    m_pvTable.updatePv(*move, 0);
-                    alpha = score;
-                    bestMove = *move;
-                }
-            }
+        if(score > bestScore)
+        {
+            bestScore = score;
+            bestMove = *move;
         }
 
-        // The move found can be used even if search is canceled, if we search the previously best move first
-        // If a better move is found, it is guaranteed to be better than the best move at the previous depth
-        // If the search is so short that the first iteration does not finish, this will still assign a searchBestMove.
-        // As long as bestMove is not a null move.
-        if(!bestMove.isNull())
+        if(score > alpha)
         {
-            searchScore = alpha;
-            searchBestMove = bestMove;
+            alpha = score;
+            m_pvTable->updatePv(*move, plyFromRoot);
         }
 
-        // Send UCI info
-        // Note: The last reported depth might not be complete if the search was stopped
-        m_sendUciInfo(board, searchScore, depth, tbResult);
-
-        // Exit search if stopped, and avoid storing incomplete search results in the transposition table
-        if(m_shouldStop())
+        if(alpha >= beta)
         {
+            if(move->isQuiet())
+            {
+                m_heuristics.killerManager.add(*move, plyFromRoot);
+            }
             break;
         }
-
-        // Store the result in the transposition table
-        m_tt.add(searchScore, searchBestMove, true, depth, 0, rawEval, TTFlag::EXACT, board.getHash());
     }
 
-    m_stats.nodes += m_numNodesSearched;
-    m_stats.tbHits += m_tbHits;
-
-    if(m_verbose)
+    if(m_shouldStop())
     {
-        Interface::UCI::sendBestMove(searchBestMove);
-        m_tt.logStats();
-        logStats();
+        return 0;
     }
 
-    // Report potential search results
-    if(searchResult != nullptr)
+    // Only proven mates are stored, as the draw score is used for positions without a proven mate
+    if(Evaluator::isRealMateScore(bestScore))
     {
-        searchResult->eval = searchScore;
-    }
+        TTFlag flag = TTFlag::EXACT;
+        if(bestScore <= originalAlpha) flag = TTFlag::UPPER_BOUND;
+        else if(bestScore >= beta)     flag = TTFlag::LOWER_BOUND;
 
-    return searchBestMove;
-}
+        eval_t rawEval = entry.has_value() ? entry->rawEval : m_evaluator.evaluate(board);
+        m_tt->add(bestScore, bestMove, false, depth, plyFromRoot, rawEval, flag, board.getHash());
+    }
 
-void Searcher::stop()
-{
-    m_stopSearch = true;
+    return bestScore;
 }
 
-bool Searcher::m_shouldStop()
+inline bool Searcher::m_isDraw(const Board& board, uint8_t plyFromRoot) const
 {
-    // Force the first depth iteration to complete
-    if(m_rootDepth <= 1)
-    {
-        return false;
-    }
-
-    // Limit the number of calls to getMs which is slow
-    if((m_numNodesSearched & 0xff) == 0)
+    // Check for repeated positions in the search and the game history preceding it
+    // * Only check for boards backwards until captures occur (halfMoves)
+    // * Only check every other board, as the turn has to be correct
+    // * A single repetition within the search is a draw,
+    //   while positions before the root have to be repeated twice
+    const int32_t limit = std::min(int32_t(plyFromRoot) + int32_t(m_numHistoryPlies), int32_t(board.getHalfMoves()));
+    const hash_t hash = board.getHash();
+    uint8_t numHistoryRepetitions = 0;
+    for(int32_t i = 2; i <= limit; i += 2)
     {
-        // Check for timeout
-        if(m_parameters.useTime && m_timer.getMs() >= m_parameters.msTime)
+        if(m_searchStacks.hashes[int32_t(plyFromRoot) - i] == hash)
         {
-            m_stopSearch = true;
+            if(i <= plyFromRoot || ++numHistoryRepetitions >= 2)
+                return true;
         }
     }
 
-    if(m_parameters.useNodes && m_numNodesSearched >= m_parameters.nodes)
+    // Check for 50 move rule
+    if(board.getHalfMoves() >= 100)
     {
-        m_stopSearch = true;
+        return true;
     }
 
-    return m_stopSearch;
+    // Check material draw
+    return board.isMaterialDraw();
 }
 
-void Searcher::m_sendUciInfo(const Board& board, eval_t score, uint32_t depth, Syzygy::WDLResult tbResult)
+// Checks if the side to move can repeat a previous position with a single reversible move
+// The hash difference to each earlier position with the opposite turn is looked up in the cuckoo tables of reversible moves
+bool Searcher::m_hasUpcomingRepetition(const Board& board, uint8_t plyFromRoot) const
 {
-    if(!m_verbose)
+    const int32_t limit = std::min(int32_t(plyFromRoot) + int32_t(m_numHistoryPlies), int32_t(board.getHalfMoves()));
+    if(limit < 3)
     {
-        return;
+        return false;
     }
 
-    // Send UCI info
+    const hash_t hash = board.getHash();
+    const bitboard_t occupied = board.getColoredPieces(Color::WHITE) | board.getColoredPieces(Color::BLACK);
+    for(int32_t i = 3; i <= limit; i += 2)
+    {
+        const hash_t previousHash = m_searchStacks.hashes[int32_t(plyFromRoot) - i];
+        Move move;
+        if(!Zobrist::getCuckooMove(hash ^ previousHash, move))
+            continue;
+
+        // The path of the move has to be empty
+        const bitboard_t path = getBetweens(move.from, move.to) & ~(bitboard_t(1) << move.to);
+        if(path & occupied)
+            continue;
+
+        // The moving piece has to belong to the side to move
+        const square_t pieceSquare = (occupied & (bitboard_t(1) << move.from)) ? move.from : move.to;
+        if(board.getColorAt(pieceSquare) != board.getTurn())
+            continue;
+
+        // The position after the move is a draw by the same rules as m_isDraw:
+        // A single repetition within the search, or two repetitions of a position before the root
+        if(i <= plyFromRoot)
+            return true;
+
+        for(int32_t j = i + 2; j <= limit; j += 2)
+        {
+            if(m_searchStacks.hashes[int32_t(plyFromRoot) - j] == previousHash)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void Searcher::m_prepareSearch(const SearchParameters& parameters)
+{
+    m_tbHits = 0;
+    {
+        // Avoid missing a ponderhit received while preparing the search
+        // The timer is started under the lock, such that ponderhit measures the ponder time from the start of this search
+        std::lock_guard<std::mutex> lock(m_clockMutex);
+        m_isPondering = parameters.ponder && !m_ponderhitPending.exchange(false);
+        m_msPonderTime = 0;
+        m_timer.start();
+    }
+    m_nsTimeStop = -1;
+    m_numNodesSearched = 0;
+    m_rootDepth = 0;
+    m_bestMove = NULL_MOVE;
+    m_bestScore = 0;
+    m_bestDepth = 0;
+    m_parameters = parameters;
+
+    // Clamp the search depth to valid values
+    if(!m_parameters.useDepth)
+    {
+        m_parameters.depth = MaxSearchDepth - 1;
+    }
+    m_parameters.depth = std::clamp(m_parameters.depth, 1u, MaxSearchDepth - 1);
+    m_nodeLimit = m_parameters.useNodes ? m_parameters.nodes : UINT64_MAX;
+    m_parameters.multiPV = std::clamp(m_parameters.multiPV, 1u, uint32_t(MaxMoveCount));
+
+    // The mate search is limited by the maximum ply of the search stacks
+    m_parameters.mate = std::min(m_parameters.mate, (MaxSearchPly - 1) / 2);
+}
+
+Move Searcher::search(Board board, SearchParameters parameters, SearchResult* searchResult)
+{
+    m_prepareSearch(parameters);
+    m_tt->incrementGeneration();
+
+    // Copy the search moves from the parameters
+    Move* moves = m_parameters.searchMoves;
+    uint8_t numMoves = m_parameters.numSearchMoves;
+
+    // Only generate moves or probe tablebase if no search moves are provided
+    // The tablebase is not probed when searching for mate, as the DTZ moves are not necessarily the shortest mate
+    Syzygy::WDLResult tbResult = Syzygy::WDLResult::FAILED;
+    if(numMoves == 0)
+    {
+        if(m_parameters.mate == 0)
+        {
+            tbResult = Syzygy::TBProbeDTZ(board, moves, numMoves);
+        }
+
+        if(tbResult == Syzygy::WDLResult::FAILED)
+        {
+            MoveList legalMoves;
+            board.generateLegalMoves(legalMoves);
+            board.generateCaptureInfo(legalMoves);
+            numMoves = legalMoves.size;
+            std::copy(legalMoves.begin(), legalMoves.end(), moves);
+        }
+    }
+
+    // Start the helper threads (Lazy SMP)
+    // The helpers search the same root moves as the main thread, and are only limited by depth.
+    // They are stopped by the main thread when it finishes its search or reaches the node limit.
+    // The mate search is only performed by the main thread.
+    uint32_t numHelpers = m_parameters.mate > 0 ? 0 : m_helpers.size();
+
+    // The nodes of all helpers are counted, so the helpers which are not started cannot keep the counts of their previous search
+    for(Searcher* helper : m_helpers)
+    {
+        helper->m_numNodesSearched = 0;
+        helper->m_tbHits = 0;
+    }
+    for(uint32_t i = 0; i < numHelpers; i++)
+    {
+        Searcher* helper = m_helpers[i];
+        SearchParameters helperParameters = m_parameters;
+        helperParameters.useTime = false;
+        helperParameters.useNodes = false;
+        helperParameters.multiPV = 1;
+        helperParameters.numSearchMoves = numMoves;
+        std::copy(moves, moves + numMoves, helperParameters.searchMoves);
+
+        helper->m_gameHistory = m_gameHistory;
+        helper->clearStop();
+        helper->m_prepareSearch(helperParameters);
+
+        helper->m_startHelperSearch(board);
+    }
+
+    m_startClock();
+
+    if(m_parameters.mate > 0)
+    {
+        m_mateSearch(board, moves, numMoves);
+    }
+    else
+    {
+        m_iterativeDeepening(board, moves, numMoves, tbResult);
+    }
+
+    m_stopClock();
+
+    for(Searcher* helper : m_helpers)
+    {
+        helper->stop();
+    }
+
+    for(uint32_t i = 0; i < numHelpers; i++)
+    {
+        m_helpers[i]->m_waitForHelperSearch();
+    }
+
+    // The best move cannot be reported before the GUI stops the search when pondering or searching infinitely
+    {
+        std::unique_lock<std::mutex> lock(m_clockMutex);
+        m_clockCondition.wait(lock, [this]{ return !(m_isPondering || m_parameters.infinite) || m_stopSearch; });
+    }
+    m_ponderhitPending = false;
+
+    Searcher* bestThread = m_selectBestThread();
+    int64_t usStopLatency = -1;
+
+    if(m_verbose)
+    {
+        // Report the PV of the selected thread if it is not the main thread
+        if(bestThread != this)
+        {
+            m_seldepth = bestThread->m_seldepth;
+            m_sendUciInfo(board, bestThread->m_bestScore, bestThread->m_bestDepth, tbResult, bestThread->m_pvTables[0]);
+        }
+
+        // Only suggest a move to ponder on if the PV is consistent with the best move
+        Move ponderMove = NULL_MOVE;
+        if(bestThread->m_pvTables[0]->getPvMove(0) == bestThread->m_bestMove)
+        {
+            ponderMove = bestThread->m_pvTables[0]->getPvMove(1);
+        }
+
+        Interface::UCI::sendBestMove(bestThread->m_bestMove, ponderMove);
+
+        // Measure the latency before logging, as it is not part of the time used by the engine
+        if(m_nsTimeStop >= 0)
+        {
+            usStopLatency = (m_timer.getNs() - m_nsTimeStop) / 1000;
+        }
+
+        m_tt->logStats();
+        logStats();
+    }
+
+    // Report potential search results
+    if(searchResult != nullptr)
+    {
+        searchResult->eval = bestThread->m_bestScore;
+        searchResult->usStopLatency = usStopLatency;
+    }
+
+    // Allow the searcher to be reused without clearing the stop flag
+    clearStop();
+
+    return bestThread->m_bestMove;
+}
+
+// Creates the root move list, initially ordered by the move ordering heuristics
+void Searcher::m_initRootMoves(Board& board, Move* moves, uint8_t numMoves)
+{
+    Move ttMove = NULL_MOVE;
+    std::optional<TTEntry> entry = m_tt->get(board.getHash(), 0);
+    if(entry.has_value())
+    {
+        PackedMove packedMove = entry->getPackedMove();
+        ttMove = board.decodeTTMove(packedMove);
+    }
+
+    m_rootMoves.clear();
+    MoveSelector moveSelector = MoveSelector(moves, numMoves, 0, &m_heuristics, &board, ttMove, m_searchStacks.moves);
+    while(const Move* move = moveSelector.getNextMove())
+    {
+        m_rootMoves.push_back(RootMove(*move));
+    }
+}
+
+// Copies the reversible part of the game history in front of the search stack, such that repetitions can be found with a single backward scan
+// The history is only used if it ends with the root, otherwise it does not lead to the searched position
+void Searcher::m_initHashStack(const Board& board)
+{
+    m_numHistoryPlies = 0;
+    if(!m_gameHistory.empty() && m_gameHistory.back() == board.getHash())
+    {
+        const size_t numPrevious = m_gameHistory.size() - 1;
+        m_numHistoryPlies = uint8_t(std::min(numPrevious, size_t(std::min(uint32_t(board.getHalfMoves()), MaxHistoryPly))));
+        for(uint8_t i = 1; i <= m_numHistoryPlies; i++)
+            m_searchStacks.hashes[-int32_t(i)] = m_gameHistory[numPrevious - i];
+    }
+
+    m_searchStacks.hashes[0] = board.getHash();
+}
+
+void Searcher::m_iterativeDeepening(Board& board, Move* moves, uint8_t numMoves, Syzygy::WDLResult tbResult)
+{
+    // Each line is the best move which is not already selected by one of the previous lines
+    uint32_t numLines = std::min(m_parameters.multiPV, uint32_t(numMoves));
+    Move lineMoves[MaxMoveCount];
+    eval_t lineScores[MaxMoveCount];
+    std::fill(lineMoves, lineMoves + numLines, NULL_MOVE);
+    std::fill(lineScores, lineScores + numLines, 0);
+
+    // Number of consecutive iterations where the best move has not changed, used for time management
+    uint32_t bestMoveStability = 0;
+
+    while(m_pvTables.size() < numLines)
+    {
+        m_pvTables.push_back(new PvTable(MaxSearchPly));
+    }
+
+    m_evaluator.initAccumulatorStack(board);
+    eval_t rawEval = m_evaluator.evaluate(board);
+    eval_t staticEval = m_adjustEval(rawEval, board);
+
+    // Initialize the search stack by pushing the initial board
+    m_initHashStack(board);
+    m_searchStacks.staticEvals[0] = staticEval;
+    m_searchStacks.moves[0]       = NULL_MOVE;
+
+    m_initRootMoves(board, moves, numMoves);
+
+    for(uint32_t depth = 1; depth <= m_parameters.depth; depth++)
+    {
+        m_rootDepth = depth;
+        Move previousBestMove = lineMoves[0];
+        eval_t previousScore = lineScores[0];
+
+        for(RootMove& rootMove : m_rootMoves)
+        {
+            rootMove.nodes = 0;
+        }
+
+        uint32_t numCompletedLines = 0;
+        for(uint32_t line = 0; line < numLines; line++)
+        {
+            m_pvTable = m_pvTables[line];
+
+            eval_t score;
+            Move bestMove = m_searchRootLine(board, lineMoves, line, lineMoves[line], lineScores[line], depth, score);
+
+            // The move found can be used even if search is canceled, if we search the previously best move first
+            // If a better move is found, it is guaranteed to be better than the best move at the previous depth
+            // If the search is so short that the first iteration does not finish, this will still assign a best move.
+            // As long as bestMove is not a null move.
+            if(!bestMove.isNull())
+            {
+                lineMoves[line] = bestMove;
+                lineScores[line] = score;
+
+                if(line == 0)
+                {
+                    m_bestMove = bestMove;
+                    m_bestScore = score;
+                    m_bestDepth = depth;
+                }
+            }
+
+            if(m_shouldStop())
+            {
+                break;
+            }
+
+            numCompletedLines++;
+        }
+
+        // A later line can score higher than the previous lines due to search instability
+        // Order the completed lines by score, such that the first line is the best line
+        if(numCompletedLines > 1)
+        {
+            m_sortLines(lineMoves, lineScores, numCompletedLines);
+            m_bestMove = lineMoves[0];
+            m_bestScore = lineScores[0];
+        }
+
+        // Send UCI info
+        // Note: The last reported depth might not be complete if the search was stopped
+        // Lines which were not searched at this depth are not reported, as they can repeat the move of an earlier line
+        for(uint32_t line = 0; line < numLines; line++)
+        {
+            if(line == 0 || (line < numCompletedLines && !lineMoves[line].isNull()))
+            {
+                m_sendUciInfo(board, lineScores[line], depth, tbResult, m_pvTables[line], line);
+            }
+        }
+
+        // Exit search if stopped, and avoid storing incomplete search results in the transposition table
+        if(m_shouldStop())
+        {
+            break;
+        }
+
+        // Store the result in the transposition table
+        m_tt->add(lineScores[0], lineMoves[0], true, depth, 0, rawEval, TTFlag::EXACT, board.getHash());
+
+        // Order the root moves for the next iteration by their score, and the effort spent on them
+        std::stable_sort(m_rootMoves.begin(), m_rootMoves.end(), [](const RootMove& a, const RootMove& b)
+        {
+            return (a.score != b.score) ? (a.score > b.score) : (a.nodes > b.nodes);
+        });
+
+        bestMoveStability = (lineMoves[0] == previousBestMove) ? bestMoveStability + 1 : 0;
+
+        // Avoid starting a new iteration if the soft time limit is exceeded
+        if(m_isSoftTimeExceeded(lineMoves[0], bestMoveStability, int32_t(previousScore) - lineScores[0]))
+        {
+            m_nsTimeStop = m_timer.getNs();
+            break;
+        }
+    }
+
+    m_stats.nodes += m_numNodesSearched;
+    m_stats.tbHits += m_tbHits;
+}
+
+// Stable sorts the lines by score in descending order, moving the PV tables along with the lines
+void Searcher::m_sortLines(Move* lineMoves, eval_t* lineScores, uint32_t numLines)
+{
+    uint8_t order[MaxMoveCount];
+    std::iota(order, order + numLines, 0);
+    std::stable_sort(order, order + numLines, [&](uint8_t a, uint8_t b) { return lineScores[a] > lineScores[b]; });
+
+    Move sortedMoves[MaxMoveCount];
+    eval_t sortedScores[MaxMoveCount];
+    std::vector<PvTable*> sortedPvTables(m_pvTables);
+    for(uint32_t i = 0; i < numLines; i++)
+    {
+        sortedMoves[i] = lineMoves[order[i]];
+        sortedScores[i] = lineScores[order[i]];
+        sortedPvTables[i] = m_pvTables[order[i]];
+    }
+
+    std::copy(sortedMoves, sortedMoves + numLines, lineMoves);
+    std::copy(sortedScores, sortedScores + numLines, lineScores);
+    m_pvTables = std::move(sortedPvTables);
+}
+
+// Searches all root moves which are not excluded by the previous lines, and returns the best move.
+// The aspiration window is centered around the score of the line from the previous iteration.
+// Returns a null move if the search is stopped before any move is found.
+Move Searcher::m_searchRootLine(Board& board, const Move* excludedMoves, uint8_t numExcludedMoves, const Move& previousBestMove, eval_t previousScore, uint32_t depth, eval_t& lineScore)
+{
+    Move bestMove = NULL_MOVE;
+    eval_t alpha = -Evaluator::MateScore;
+    eval_t beta = Evaluator::MateScore;
+    eval_t aspirationWindowAlpha = 35;
+    eval_t aspirationWindowBeta  = 35;
+
+    // The best move from the previous iteration is searched first.
+    // This is in case the move from the transposition is not 'correct' due to a miss.
+    // Misses can happen if the position cannot replace another position
+    // This is required to allow using results of incomplete searches
+    auto previousBestIt = std::find_if(m_rootMoves.begin(), m_rootMoves.end(), [&](const RootMove& rootMove) { return rootMove.move == previousBestMove; });
+    if(previousBestIt != m_rootMoves.end())
+    {
+        std::rotate(m_rootMoves.begin(), previousBestIt, previousBestIt + 1);
+    }
+
+    bool rerun = true;
+    while(rerun && !m_shouldStop())
+    {
+        rerun = false;
+        m_seldepth = 0;
+        bestMove = NULL_MOVE;
+
+        // Aspiration window
+        // Stop using aspiration if the search score or window size is too high
+        bool useAspAlpha = depth > 5 && std::abs(previousScore) < 900 && aspirationWindowAlpha < 600;
+        bool useAspBeta  = depth > 5 && std::abs(previousScore) < 900 && aspirationWindowBeta < 600;
+        alpha = useAspAlpha ? (previousScore - aspirationWindowAlpha) : -Evaluator::MateScore;
+        beta  = useAspBeta  ? (previousScore + aspirationWindowBeta ) : Evaluator::MateScore;
+
+        m_heuristics.killerManager.clearPly(1);
+
+        UndoRecord undo;
+        uint8_t numSearchedMoves = 0;
+        for(RootMove& rootMove : m_rootMoves)
+        {
+            const Move *move = &rootMove.move;
+
+            // Skip moves which are already reported in a previous line
+            if(std::find(excludedMoves, excludedMoves + numExcludedMoves, *move) != excludedMoves + numExcludedMoves)
+            {
+                continue;
+            }
+
+            // Moves failing low only have an upper bound, and are ordered by the number of nodes
+            rootMove.score = -Evaluator::MateScore;
+
+            // Report the move being searched when the search is long enough for it to be useful
+            if(m_verbose && m_timer.getMs() > 3000)
+            {
+                Interface::UCI::sendCurrMove(*move, numSearchedMoves + 1, depth);
+            }
+
+            m_evaluator.pushMoveToAccumulator(board, *move);
+            board.makeMove(*move, undo);
+            m_tt->prefetch(board.getHash());
+            m_searchStacks.moves[0] = *move;
+            uint64_t moveStartNodes = m_numNodesSearched;
+
+            eval_t score;
+            if(numSearchedMoves++ == 0)
+            {
+                score = -m_alphaBeta<true>(board, -beta, -alpha, depth - 1, 1, false, 0);
+            }
+            else
+            {
+                score = -m_alphaBeta<false>(board, -alpha - 1, -alpha, depth - 1, 1, true, 0);
+
+                if(score > alpha)
+                {
+                    score = -m_alphaBeta<true>(board, -beta, -alpha, depth - 1, 1, false, 0);
+                }
+            }
+
+            board.unmakeMove(*move, undo);
+            m_evaluator.popMoveFromAccumulator();
+            rootMove.nodes += m_numNodesSearched - moveStartNodes;
+
+            // Aspiration window
+            // Check if the score is lower than alpha for the first move
+            if(numSearchedMoves == 1 && useAspAlpha && score <= alpha)
+            {
+                rerun = true;
+                aspirationWindowAlpha += aspirationWindowAlpha;
+                m_stats.aspirationAlphaFails++;
+                break;
+            }
+
+            if(m_shouldStop())
+            {
+                break;
+            }
+
+            // Check if the score was outside the aspiration window
+            // It is important to break before the best move is assigned,
+            // to avoid returning a move which is outside the window when search is stopped
+            if(useAspBeta && (score >= beta))
+            {
+                rerun = true;
+                aspirationWindowBeta += aspirationWindowBeta;
+                m_stats.aspirationBetaFails++;
+                break;
+            }
+
+            if(score > alpha)
+            {
+                m_pvTable->updatePv(*move, 0);
+                alpha = score;
+                bestMove = *move;
+                rootMove.score = score;
+                rootMove.pv.clear();
+                for(uint8_t ply = 0; ply < m_pvTable->getPvLength(); ply++)
+                {
+                    rootMove.pv.push_back(m_pvTable->getPvMove(ply));
+                }
+            }
+        }
+    }
+
+    lineScore = alpha;
+    return bestMove;
+}
+
+// Searches for a mate within the number of moves given by the search parameters.
+// Each iteration searches for a mate in one more move, with a window only containing mates within the depth.
+// The first mate found is therefore the shortest, and the search terminates as soon as it is proven.
+void Searcher::m_mateSearch(Board& board, Move* moves, uint8_t numMoves)
+{
+    m_pvTable = m_pvTables[0];
+    m_evaluator.initAccumulatorStack(board);
+    m_initHashStack(board);
+    m_searchStacks.moves[0]  = NULL_MOVE;
+
+    // Report a legal move if no mate is found
+    if(numMoves > 0)
+    {
+        m_bestMove = moves[0];
+    }
+
+    for(uint32_t mateMoves = 1; mateMoves <= m_parameters.mate; mateMoves++)
+    {
+        uint32_t depth = 2 * mateMoves - 1;
+        m_rootDepth = depth;
+        m_seldepth = 0;
+
+        eval_t alpha = Evaluator::MateScore - depth - 1;
+        eval_t beta = Evaluator::MateScore;
+        bool mateFound = false;
+
+        m_pvTable->updatePvLength(0);
+        m_heuristics.killerManager.clearPly(1);
+        UndoRecord undo;
+        MoveSelector moveSelector = MoveSelector(moves, numMoves, 0, &m_heuristics, &board, m_bestMove, m_searchStacks.moves);
+        while(const Move* move = moveSelector.getNextMove())
+        {
+            m_evaluator.pushMoveToAccumulator(board, *move);
+            board.makeMove(*move, undo);
+
+            // With a single ply left, only moves giving check can mate
+            if(depth == 1 && !board.isChecked())
+            {
+                board.unmakeMove(*move, undo);
+                m_evaluator.popMoveFromAccumulator();
+                continue;
+            }
+
+            m_tt->prefetch(board.getHash());
+            m_searchStacks.moves[0] = *move;
+            eval_t score = -m_alphaBetaMate(board, -beta, -alpha, depth - 1, 1);
+            board.unmakeMove(*move, undo);
+            m_evaluator.popMoveFromAccumulator();
+
+            if(m_shouldStop())
+            {
+                break;
+            }
+
+            if(score > alpha)
+            {
+                m_pvTable->updatePv(*move, 0);
+                m_bestMove = *move;
+                m_bestScore = score;
+                m_bestDepth = depth;
+                mateFound = true;
+                break;
+            }
+        }
+
+        // The PV is only reported when a mate is found
+        m_sendUciInfo(board, mateFound ? m_bestScore : DRAW_VALUE, depth, Syzygy::WDLResult::FAILED, mateFound ? m_pvTable : nullptr);
+
+        if(mateFound || m_shouldStop())
+        {
+            break;
+        }
+    }
+
+    m_stats.nodes += m_numNodesSearched;
+}
+
+Searcher* Searcher::m_selectBestThread()
+{
+    Searcher* bestThread = this;
+
+    // The helpers only search a single line, so the main thread is used when searching multiple lines.
+    // The helpers do not take part in the mate search.
+    if(m_helpers.empty() || m_parameters.multiPV > 1 || m_parameters.mate > 0)
+    {
+        return bestThread;
+    }
+
+    std::vector<Searcher*> threads = { this };
+    threads.insert(threads.end(), m_helpers.begin(), m_helpers.end());
+
+    eval_t minScore = Evaluator::MateScore;
+    for(Searcher* thread : threads)
+    {
+        if(!thread->m_bestMove.isNull())
+        {
+            minScore = std::min(minScore, thread->m_bestScore);
+        }
+    }
+
+    // Each thread votes for its best move, weighted by its score and the depth it reached
+    auto getVotes = [&](const Move& move)
+    {
+        int64_t votes = 0;
+        for(Searcher* thread : threads)
+        {
+            if(thread->m_bestMove == move)
+            {
+                votes += int64_t(thread->m_bestScore - minScore + 14) * thread->m_bestDepth;
+            }
+        }
+        return votes;
+    };
+
+    for(Searcher* thread : threads)
+    {
+        if(thread->m_bestMove.isNull())
+        {
+            continue;
+        }
+
+        // Always prefer the quickest win, otherwise select the move with the most votes
+        if(Evaluator::isWinningScore(thread->m_bestScore) || Evaluator::isWinningScore(bestThread->m_bestScore))
+        {
+            if(thread->m_bestScore > bestThread->m_bestScore)
+            {
+                bestThread = thread;
+            }
+        }
+        else if(getVotes(thread->m_bestMove) > getVotes(bestThread->m_bestMove))
+        {
+            bestThread = thread;
+        }
+    }
+
+    return bestThread;
+}
+
+void Searcher::stop()
+{
+    {
+        // Set under the lock to avoid missing the wakeup of a search waiting for stop
+        std::lock_guard<std::mutex> lock(m_clockMutex);
+        m_stopSearch = true;
+    }
+
+    m_clockCondition.notify_all();
+}
+
+// The stop flag is not cleared when the search starts, such that a stop received before the search has started is not lost.
+// It is cleared when the search is done, and by the UCI before requesting a new search.
+void Searcher::clearStop()
+{
+    m_stopSearch = false;
+}
+
+// Switch from pondering to a normal timed search, keeping the current search tree
+void Searcher::ponderhit()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_clockMutex);
+        m_ponderhitPending = true;
+
+        // The ponder time is recorded before the search can see that pondering has ended
+        if(m_isPondering)
+        {
+            m_msPonderTime = m_timer.getMs();
+            m_isPondering = false;
+        }
+    }
+
+    m_clockCondition.notify_all();
+}
+
+inline void Searcher::m_countNode()
+{
+    // The counter is only written by the owning thread, but is read by the main thread
+    uint64_t numNodesSearched = m_numNodesSearched.load(std::memory_order_relaxed) + 1;
+    m_numNodesSearched.store(numNodesSearched, std::memory_order_relaxed);
+
+    // The node limit is checked in batches to keep the overhead low
+    // Only the main thread has a node limit, which is checked against the nodes of all threads
+    if((numNodesSearched & 0x3f) == 0 && m_nodeLimit != UINT64_MAX && m_getTotalNodes() >= m_nodeLimit)
+    {
+        m_stopSearch.store(true, std::memory_order_relaxed);
+        for(Searcher* helper : m_helpers)
+        {
+            helper->m_stopSearch.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t Searcher::m_getTotalNodes() const
+{
+    uint64_t nodes = m_numNodesSearched.load(std::memory_order_relaxed);
+    for(const Searcher* helper : m_helpers)
+    {
+        nodes += helper->m_numNodesSearched.load(std::memory_order_relaxed);
+    }
+    return nodes;
+}
+
+uint64_t Searcher::m_getTotalTbHits() const
+{
+    uint64_t tbHits = m_tbHits.load(std::memory_order_relaxed);
+    for(const Searcher* helper : m_helpers)
+    {
+        tbHits += helper->m_tbHits.load(std::memory_order_relaxed);
+    }
+    return tbHits;
+}
+
+// The time limit is handled by the clock thread, and the node limit is checked when counting nodes.
+// Thus, only the stop flag has to be checked.
+bool Searcher::m_shouldStop()
+{
+    // Force the first depth iteration to complete
+    if(m_rootDepth <= 1)
+    {
+        return false;
+    }
+
+    return m_stopSearch.load(std::memory_order_relaxed);
+}
+
+// Runs the searches of a helper, which sleeps between the searches
+void Searcher::m_runHelper(uint32_t node)
+{
+    Numa::bindThread(node);
+
+    std::unique_lock<std::mutex> lock(m_helperMutex);
+    while(true)
+    {
+        m_helperCondition.wait(lock, [this]{ return m_helperSearching || m_helperExit; });
+
+        if(m_helperExit)
+        {
+            break;
+        }
+
+        lock.unlock();
+        m_iterativeDeepening(m_helperBoard, m_parameters.searchMoves, m_parameters.numSearchMoves, Syzygy::WDLResult::FAILED);
+        lock.lock();
+
+        m_helperSearching = false;
+        m_helperCondition.notify_all();
+    }
+}
+
+// Wakes the helper thread to search the board with the prepared parameters
+void Searcher::m_startHelperSearch(const Board& board)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_helperMutex);
+        m_helperBoard = board;
+        m_helperSearching = true;
+    }
+
+    m_helperCondition.notify_all();
+}
+
+void Searcher::m_waitForHelperSearch()
+{
+    std::unique_lock<std::mutex> lock(m_helperMutex);
+    m_helperCondition.wait(lock, [this]{ return !m_helperSearching; });
+}
+
+// Runs the clock of each timed search, and sleeps between the searches
+void Searcher::m_runClock()
+{
+    std::unique_lock<std::mutex> lock(m_clockMutex);
+    while(true)
+    {
+        m_clockCondition.wait(lock, [this]{ return m_clockRunning || m_clockThreadExit; });
+
+        if(m_clockThreadExit)
+        {
+            break;
+        }
+
+        m_timeSearch(lock);
+
+        m_clockRunning = false;
+        m_clockCondition.notify_all();
+    }
+}
+
+// Stops the search when the time limit is reached. The time spent pondering is not counted.
+// The clock sleeps until the deadline, and is woken up early by ponderhit or when the search is done.
+void Searcher::m_timeSearch(std::unique_lock<std::mutex>& lock)
+{
+    // Wait for ponderhit before starting the clock
+    if(m_isPondering)
+    {
+        m_clockCondition.wait(lock, [this]{ return !m_isPondering || m_clockExit; });
+    }
+
+    while(!m_clockExit)
+    {
+        int64_t msLeft = m_parameters.msTime + m_msPonderTime - m_timer.getMs();
+        if(msLeft <= 0)
+        {
+            m_nsTimeStop = m_timer.getNs();
+            m_stopSearch = true;
+            break;
+        }
+
+        m_clockCondition.wait_for(lock, std::chrono::milliseconds(msLeft));
+    }
+}
+
+void Searcher::m_startClock()
+{
+    if(!m_parameters.useTime)
+    {
+        return;
+    }
+
+    if(!m_clockThread.joinable())
+    {
+        m_clockThread = std::thread(&Searcher::m_runClock, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_clockMutex);
+        m_clockExit = false;
+        m_clockRunning = true;
+    }
+
+    m_clockCondition.notify_all();
+}
+
+// Waits for the clock to be done with the search, such that it cannot stop the next search
+void Searcher::m_stopClock()
+{
+    std::unique_lock<std::mutex> lock(m_clockMutex);
+    m_clockExit = true;
+    m_clockCondition.notify_all();
+    m_clockCondition.wait(lock, [this]{ return !m_clockRunning; });
+}
+
+// Returns the fraction of the nodes in the current iteration which are spent on the given root move
+float Searcher::m_getNodeFraction(const Move& move) const
+{
+    uint64_t totalNodes = 0;
+    uint64_t moveNodes = 0;
+    for(const RootMove& rootMove : m_rootMoves)
+    {
+        totalNodes += rootMove.nodes;
+        if(rootMove.move == move)
+        {
+            moveNodes = rootMove.nodes;
+        }
+    }
+
+    return totalNodes > 0 ? float(moveNodes) / totalNodes : 0.0f;
+}
+
+// Checks if the soft time limit, scaled by the stability of the search, is exceeded.
+// The search uses less time when the best move is stable and has most of the nodes,
+// and more time when the best move changes or the score drops.
+bool Searcher::m_isSoftTimeExceeded(const Move& bestMove, uint32_t bestMoveStability, int32_t scoreDrop)
+{
+    if(!m_parameters.useTime || m_parameters.msSoftTime <= 0 || m_isPondering)
+    {
+        return false;
+    }
+
+    float stabilityScale = 1.8f - 0.1f * std::min(bestMoveStability, 10u);
+    float scoreScale     = std::clamp(1.0f + scoreDrop / 100.0f, 0.8f, 1.5f);
+    float nodeScale      = 1.35f * (1.5f - m_getNodeFraction(bestMove));
+
+    int64_t msSoftTime = m_parameters.msSoftTime * stabilityScale * scoreScale * nodeScale;
+    return m_timer.getMs() - m_msPonderTime >= msSoftTime;
+}
+
+void Searcher::m_sendUciInfo(const Board& board, eval_t score, uint32_t depth, Syzygy::WDLResult tbResult, PvTable* pvTable, uint32_t line)
+{
+    if(!m_verbose)
+    {
+        return;
+    }
+
+    // Send UCI info
     Interface::SearchInfo info = Interface::SearchInfo();
     info.depth = depth;
     info.seldepth = m_seldepth;
+    info.multiPV = m_parameters.multiPV > 1 ? line + 1 : 0;
     info.msTime = m_timer.getMs();
     info.nsTime = m_timer.getNs();
-    info.nodes = m_numNodesSearched;
+    info.nodes = m_getTotalNodes();
     info.score = score;
-    info.hashfull = m_tt.permills();
-    info.pvTable = &m_pvTable;
-    info.tbHits = m_tbHits;
+    info.hashfull = m_tt->permills();
+    info.pvTable = pvTable;
+    info.tbHits = m_getTotalTbHits();
     info.board = board;
     if(Evaluator::isRealMateScore(score))
     {
@@ -1039,6 +2045,7 @@ void Searcher::logStats()
     ss << "\n----------------------------------";
     ss << "\nNodes                      " << m_stats.nodes;
     ss << "\nEvaluated Positions:       " << m_stats.evaluations;
+    ss << "\nBatch Evaluated Positions: " << m_stats.batchedEvaluations;
     ss << "\nPV-Nodes:                  " << m_stats.pvNodes;
     ss << "\nNon-PV-Nodes:              " << m_stats.nonPvNodes;
     ss << "\nQsearch-Nodes              " << m_stats.qSearchNodes;
@@ -1082,19 +2089,34 @@ void Searcher::logStats()
     DEBUG(ss.str())
 }
 
-std::unordered_map<hash_t, uint8_t, HashFunction>& Searcher::getHistory()
+// Counts the occurrences of the board in the game history, within the plies since the last irreversible move
+// The board is expected to be the last position added to the history
+uint8_t Searcher::getNumOccurrences(const Board& board) const
 {
-    return m_gameHistory;
+    const int32_t size  = int32_t(m_gameHistory.size());
+    const int32_t limit = std::min(size - 1, int32_t(board.getHalfMoves()));
+    const hash_t hash   = board.getHash();
+    uint8_t numOccurrences = 0;
+    for(int32_t i = 0; i <= limit; i += 2)
+    {
+        if(m_gameHistory[size - 1 - i] == hash)
+            numOccurrences++;
+    }
+
+    return numOccurrences;
+}
+
+// Checks if the side to move can draw by repetition with its next move, as judged at the root of a search
+// The board is expected to be the last position added to the history
+bool Searcher::hasUpcomingRepetition(const Board& board)
+{
+    m_initHashStack(board);
+    return m_hasUpcomingRepetition(board, 0);
 }
 
 void Searcher::addBoardToHistory(const Board& board)
 {
-    hash_t hash = board.getHash();
-    auto it = m_gameHistory.find(hash);
-    if(it == m_gameHistory.end())
-        m_gameHistory.emplace(hash, 1);
-    else
-        it->second += 1;
+    m_gameHistory.push_back(board.getHash());
 }
 
 void Searcher::clearHistory()
@@ -9,27 +9,28 @@
 #include <timer.hpp>
 #include <syzygy.hpp>
 #include <vector>
-#include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace Arcanum
 {
     constexpr uint32_t MaxSearchDepth = 64;// Maximum search depth in root
     constexpr uint32_t MaxSearchPly = 96;  // Maximum number of half-moves ply from root
-
-    class HashFunction
-    {
-        public:
-        size_t operator()(const hash_t& hash) const {
-            return hash;
-        }
-    };
+    constexpr uint32_t MaxHistoryPly = 100;// Maximum number of half-moves before the root which can be repeated (50 move rule)
 
     struct SearchStacks
     {
-        hash_t hashes      [MaxSearchPly];
+        hash_t hashHistory [MaxHistoryPly + MaxSearchPly]; // Hashes of the game leading to the root, followed by the hashes of the search
+        hash_t* hashes;                                    // Hashes from the root, such that hashes[-i] is the position i plies before the root
         eval_t staticEvals [MaxSearchPly];
         Move   moves       [MaxSearchPly];
+
+        SearchStacks() : hashes(hashHistory + MaxHistoryPly) {}
+        SearchStacks(const SearchStacks&) = delete;
+        SearchStacks& operator=(const SearchStacks&) = delete;
     };
 
     // https://www.wbec-ridderkerk.nl/html/UCIProtocol.html
@@ -38,6 +39,7 @@ namespace Arcanum
     {
         uint64_t nodes;       // Number of nodes visited
         uint64_t evaluations; // Number of calls to board.evaulate()
+        uint64_t batchedEvaluations; // Number of positions evaluated in batches in the quiescence search
         uint64_t pvNodes;
         uint64_t nonPvNodes;
         uint64_t qSearchNodes;
@@ -70,6 +72,7 @@ namespace Arcanum
         SearchStats() :
             nodes(0),
             evaluations(0),
+            batchedEvaluations(0),
             pvNodes(0),
             nonPvNodes(0),
             qSearchNodes(0),
@@ -108,11 +111,14 @@ namespace Arcanum
         bool useNodes;
         bool useDepth;
 
-        int64_t msTime;
+        int64_t msTime;     // Hard time limit, checked during the search
+        int64_t msSoftTime; // Soft time limit, checked between iterations and scaled by the stability of the search. Unused if 0
         uint64_t nodes;
         uint32_t depth;
-        uint32_t mate; // TODO: This requires a search with only exact pruning
+        uint32_t mate; // Search only for a mate in this number of moves, using exact pruning only. Disabled if 0
         bool infinite;
+        bool ponder; // Search without time limits until ponderhit is received
+        uint32_t multiPV; // Number of best lines to search and report
         uint32_t numSearchMoves;
         Move searchMoves[MaxMoveCount];
 
@@ -121,24 +127,53 @@ namespace Arcanum
             useNodes(false),
             useDepth(false),
             msTime(0),
+            msSoftTime(0),
             nodes(0),
             depth(0),
             mate(0),
             infinite(false),
+            ponder(false),
+            multiPV(1),
             numSearchMoves(0)
         {};
     };
 
+    struct RootMove
+    {
+        Move move;
+        eval_t score;          // Score from the last search of the move. Only exact if the move raised alpha, otherwise -MateScore
+        uint64_t nodes;        // Number of nodes spent searching the move in the current iteration
+        std::vector<Move> pv;  // PV from the last search where the move raised alpha
+
+        RootMove(const Move& move) :
+            move(move),
+            score(-Evaluator::MateScore),
+            nodes(0)
+        {};
+    };
+
     struct SearchResult
     {
         eval_t eval;
+        int64_t usStopLatency; // Time from stopping the search due to the time limit until the best move is sent. Negative if not stopped by time
     };
 
     class Searcher
     {
         private:
-            std::unordered_map<hash_t, uint8_t, HashFunction> m_gameHistory;
-            TranspositionTable m_tt;
+            std::vector<hash_t> m_gameHistory; // Hashes of all positions in the game, ending with the current position
+            uint8_t m_numHistoryPlies;         // Number of positions from the game history copied in front of the search stack
+            TranspositionTable* m_tt; // Owned by the main searcher and shared with the helpers
+            bool m_isHelper;
+            std::vector<Searcher*> m_helpers;
+
+            // Each helper searches on a persistent thread bound to its NUMA node, which is woken for each search
+            std::thread m_helperThread;
+            std::mutex m_helperMutex;
+            std::condition_variable m_helperCondition;
+            bool m_helperSearching;
+            bool m_helperExit;
+            Board m_helperBoard;
             SearchStacks m_searchStacks;
             uint8_t* m_lmrReductions;
             uint32_t m_lmpThresholds[2][MaxSearchDepth];
@@ -146,38 +181,87 @@ namespace Arcanum
             Timer m_timer;
             Evaluator m_evaluator;
             MoveOrderHeuristics m_heuristics;
-            PvTable m_pvTable;
+            std::vector<RootMove> m_rootMoves; // Root moves kept across iterations, ordered by score and effort
+            std::vector<PvTable*> m_pvTables; // One PV table for each line searched with MultiPV
+            PvTable* m_pvTable; // PV table of the line currently being searched
             SearchParameters m_parameters;
             SearchStats m_stats;
-            uint64_t m_tbHits;
-            uint64_t m_numNodesSearched; // Number of nodes searched in a search call. Used to terminate search based on number of nodes.
+            std::atomic<uint64_t> m_tbHits;
+            std::atomic<uint64_t> m_numNodesSearched; // Number of nodes searched in a search call. Used to terminate search based on number of nodes.
             uint8_t m_seldepth;
             uint32_t m_rootDepth;
             bool m_verbose; // Print use output and stats while searching
-            volatile bool m_stopSearch;
+            std::atomic<bool> m_stopSearch;
+            std::atomic<bool> m_isPondering;
+            std::atomic<bool> m_ponderhitPending; // Set if ponderhit is received before the search has started
+            std::atomic<int64_t> m_msPonderTime; // Time spent pondering before ponderhit, which is not counted towards the time limit
+            int64_t m_nsTimeStop; // Time when the search was stopped by the time limit. Negative if not stopped by time
+            uint64_t m_nodeLimit; // Maximum number of nodes to search. UINT64_MAX if unlimited
+
+            // The clock thread sets the stop flag when the time limit is reached
+            // It is started by the first timed search, and sleeps between searches
+            std::thread m_clockThread;
+            std::mutex m_clockMutex;
+            std::condition_variable m_clockCondition;
+            bool m_clockRunning; // Set while the clock is timing a search
+            bool m_clockExit;    // Set when the timed search is done
+            bool m_clockThreadExit;
+
+            // Result of the last search call, used when voting for the best thread
+            Move m_bestMove;
+            eval_t m_bestScore;
+            uint32_t m_bestDepth;
 
+            Searcher(bool verbose, TranspositionTable* sharedTT);
+            void m_prepareSearch(const SearchParameters& parameters);
+            void m_iterativeDeepening(Board& board, Move* moves, uint8_t numMoves, Syzygy::WDLResult tbResult);
+            void m_initRootMoves(Board& board, Move* moves, uint8_t numMoves);
+            void m_initHashStack(const Board& board);
+            Move m_searchRootLine(Board& board, const Move* excludedMoves, uint8_t numExcludedMoves, const Move& previousBestMove, eval_t previousScore, uint32_t depth, eval_t& lineScore);
+            void m_mateSearch(Board& board, Move* moves, uint8_t numMoves);
+            Searcher* m_selectBestThread();
+            uint64_t m_getTotalNodes() const;
+            uint64_t m_getTotalTbHits() const;
+            void m_countNode();
             eval_t m_adjustEval(eval_t rawEval, Board& board);
             bool m_isDraw(const Board& board, uint8_t plyFromRoot) const;
+            bool m_hasUpcomingRepetition(const Board& board, uint8_t plyFromRoot) const;
             bool m_shouldStop();
-            void m_sendUciInfo(const Board& board, eval_t score, uint32_t depth, Syzygy::WDLResult tbResult);
+            void m_runHelper(uint32_t node);
+            void m_startHelperSearch(const Board& board);
+            void m_waitForHelperSearch();
+            void m_runClock();
+            void m_timeSearch(std::unique_lock<std::mutex>& lock);
+            void m_startClock();
+            void m_stopClock();
+            float m_getNodeFraction(const Move& move) const;
+            bool m_isSoftTimeExceeded(const Move& bestMove, uint32_t bestMoveStability, int32_t scoreDrop);
+            void m_sortLines(Move* lineMoves, eval_t* lineScores, uint32_t numLines);
+            void m_sendUciInfo(const Board& board, eval_t score, uint32_t depth, Syzygy::WDLResult tbResult, PvTable* pvTable, uint32_t line = 0);
             void m_initializeTables();
             uint8_t m_getReduction(uint8_t depth, uint8_t moveNumber) const;
 
             template <bool isPv>
             eval_t m_alphaBeta(Board& board, eval_t alpha, eval_t beta, int depth, int plyFromRoot, bool cutnode, uint8_t totalExtensions, Move skipMove = NULL_MOVE);
+            const Move* m_getNextQSearchMove(MoveSelector& moveSelector, Board& board, bool isChecked);
             template <bool isPv>
             eval_t m_alphaBetaQuiet(Board& board, eval_t alpha, eval_t beta, int plyFromRoot);
+            eval_t m_alphaBetaMate(Board& board, eval_t alpha, eval_t beta, int depth, int plyFromRoot);
         public:
             Searcher(bool verbose = true);
             ~Searcher();
             Move search(Board board, SearchParameters parameters, SearchResult* searchResult = nullptr);
             void stop();
+            void clearStop();
+            void ponderhit();
             void resizeTT(uint32_t mbSize);
+            void setNumThreads(uint32_t numThreads);
             void clear();
             void setVerbose(bool enable);
             SearchStats getStats();
             void logStats();
-            std::unordered_map<hash_t, uint8_t, HashFunction>& getHistory();
+            uint8_t getNumOccurrences(const Board& board) const;
+            bool hasUpcomingRepetition(const Board& board);
             void addBoardToHistory(const Board& board);
             void clearHistory();
     };
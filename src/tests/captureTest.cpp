@@ -7,18 +7,20 @@ using namespace Arcanum;
 static void playAllMovesAndCheckCaptures(Board& board, uint32_t depth, bool* failed)
 {
     // Find captures and queen promotions
-    board.getLegalCaptureMoves();
-    uint8_t numNoisyMoves = board.getNumLegalMoves();
+    MoveList noisyMoves;
+    board.generateLegalCaptureMoves(noisyMoves);
+    uint8_t numNoisyMoves = noisyMoves.size;
 
-    Move* legalMoves = board.getLegalMoves();
-    uint8_t numLegalMoves = board.getNumLegalMoves();
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    uint8_t numLegalMoves = legalMoves.size;
 
     if(numLegalMoves == 0)
     {
         return;
     }
 
-    board.generateCaptureInfo();
+    board.generateCaptureInfo(legalMoves);
 
     uint8_t numCapturesAndPromotions = 0;
     if(!board.isChecked())
@@ -46,6 +48,95 @@ static void playAllMovesAndCheckCaptures(Board& board, uint32_t depth, bool* fai
         return;
     }
 
+    // The legal noisy and quiet moves together should be all the legal moves
+    MoveList stagedMoves;
+    board.generatePseudoLegalNoisyMoves(stagedMoves);
+    uint8_t numStagedNoisyMoves = stagedMoves.size;
+    board.generatePseudoLegalQuietMoves(stagedMoves);
+    board.generateCaptureInfo(stagedMoves);
+    uint8_t numStagedLegalMoves = 0;
+    for(uint8_t i = 0; i < stagedMoves.size; i++)
+    {
+        if(!board.isLegal(stagedMoves[i]))
+        {
+            continue;
+        }
+
+        numStagedLegalMoves++;
+        if(!board.isChecked() && (i >= numStagedNoisyMoves) && !stagedMoves[i].isQuiet())
+        {
+            *failed = true;
+            FAIL("Non-quiet move " << stagedMoves[i] << " generated as quiet move in position " << board.fen())
+            return;
+        }
+    }
+
+    if(numStagedLegalMoves != numLegalMoves)
+    {
+        *failed = true;
+        FAIL("Mismatch in number of legal staged moves. Expected " << (int)numLegalMoves << " but got " << (int)numStagedLegalMoves << " in position " << board.fen())
+        return;
+    }
+
+    if(board.countLegalMoves() != numLegalMoves)
+    {
+        *failed = true;
+        FAIL("Mismatch in number of counted legal moves. Expected " << (int)numLegalMoves << " but got " << (int)board.countLegalMoves() << " in position " << board.fen())
+        return;
+    }
+
+    // Every legal move should also be accepted by isLegal
+    for(uint8_t i = 0; i < numLegalMoves; i++)
+    {
+        if(!board.isLegal(legalMoves[i]))
+        {
+            *failed = true;
+            FAIL("Legal move " << legalMoves[i] << " rejected by isLegal in position " << board.fen())
+            return;
+        }
+    }
+
+    // Every legal move should be reconstructed from its packed move
+    for(uint8_t i = 0; i < numLegalMoves; i++)
+    {
+        Move decoded = board.decodeTTMove(PackedMove(legalMoves[i]));
+        if((decoded != legalMoves[i]) || (decoded.moveInfo != legalMoves[i].moveInfo))
+        {
+            *failed = true;
+            FAIL("Legal move " << legalMoves[i] << " decoded as " << decoded << " in position " << board.fen())
+            return;
+        }
+    }
+
+    // Every packed move accepted by isPseudoLegal and isLegal should be a legal move
+    // This is only checked close to the root, as all 64*64*5 packed moves are tried
+    if(depth >= 3)
+    {
+        constexpr uint16_t PromotionBits[5] = { 0b000, 0b100, 0b101, 0b110, 0b111 };
+        uint8_t numDecodedLegalMoves = 0;
+        for(uint16_t from = 0; from < 64; from++)
+        {
+            for(uint16_t to = 0; to < 64; to++)
+            {
+                for(uint16_t promotion : PromotionBits)
+                {
+                    Move decoded = board.decodeTTMove(PackedMove(uint16_t((promotion << 12) | (from << 6) | to)));
+                    if(!decoded.isNull() && board.isLegal(decoded))
+                    {
+                        numDecodedLegalMoves++;
+                    }
+                }
+            }
+        }
+
+        if(numDecodedLegalMoves != numLegalMoves)
+        {
+            *failed = true;
+            FAIL("Mismatch in number of legal decoded moves. Expected " << (int)numLegalMoves << " but got " << (int)numDecodedLegalMoves << " in position " << board.fen())
+            return;
+        }
+    }
+
     if(depth == 0)
     {
         return;
@@ -68,8 +159,8 @@ static void playAllMovesAndCheckCaptures(Board& board, uint32_t depth, bool* fai
 }
 
 // This test goes through a number of positions recursively and checks that
-// the number of captures and promotions generated by getLegalCaptureMoves and getNumLegalMoves are consistent
-// If in check, getLegalCaptureMoves should return all legal moves
+// the number of captures and promotions generated by generateLegalCaptureMoves and generateLegalMoves are consistent
+// If in check, generateLegalCaptureMoves should return all legal moves
 bool Test::runCaptureTest()
 {
     bool failed = false;
@@ -113,5 +204,18 @@ bool Test::runCaptureTest()
         SUCCESS("Completed position with promotions")
     }
 
+    // Test position with pins, checks and castling
+    Board boardPins = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    playAllMovesAndCheckCaptures(boardPins, 3, &failed);
+    if(failed)
+    {
+        FAIL("Failed position with pins")
+        return false;
+    }
+    else
+    {
+        SUCCESS("Completed position with pins")
+    }
+
     return true;
 }
\ No newline at end of file
@@ -20,14 +20,27 @@ static bool testCheckmateWithoutRepeat()
     runner.setMoveLimit(10);
 
     // Setup the board and history such that the shortest checkmate would be a 3-fold repetition
+    // The history is played from the repeated position, such that it is visited twice before the initial position
     const Board repeat = Board("k7/1p1p1p2/pPpPpPp1/P1P1P1P1/7R/8/8/K7 b - - 0 1");
-    runner.getSearcher(Color::WHITE).addBoardToHistory(repeat);
-    runner.getSearcher(Color::WHITE).addBoardToHistory(repeat);
-    runner.getSearcher(Color::BLACK).addBoardToHistory(repeat);
-    runner.getSearcher(Color::BLACK).addBoardToHistory(repeat);
+    const Move historyMoves[] = {
+        Move(Square::A8, Square::B8, MoveInfoBit::KING_MOVE),
+        Move(Square::H4, Square::H3, MoveInfoBit::ROOK_MOVE),
+        Move(Square::B8, Square::A8, MoveInfoBit::KING_MOVE),
+        Move(Square::H3, Square::H4, MoveInfoBit::ROOK_MOVE),
+        Move(Square::A8, Square::B8, MoveInfoBit::KING_MOVE),
+        Move(Square::H4, Square::A4, MoveInfoBit::ROOK_MOVE),
+        Move(Square::B8, Square::A8, MoveInfoBit::KING_MOVE),
+    };
+
+    Board initialBoard = Board(repeat);
+    for(const Move& move : historyMoves)
+    {
+        runner.getSearcher(Color::WHITE).addBoardToHistory(initialBoard);
+        runner.getSearcher(Color::BLACK).addBoardToHistory(initialBoard);
+        initialBoard.performMove(move);
+    }
 
     // Play the game out
-    const Board initialBoard = Board("k7/1p1p1p2/pPpPpPp1/P1P1P1P1/R7/8/8/K7 w - - 0 1");
     runner.setInitialPosition(initialBoard);
     runner.play(false);
 
@@ -61,11 +74,73 @@ static bool testCheckmateWithoutRepeat()
     return true;
 }
 
+// Plays the moves from the position, and checks if the side to move in the final position can draw by repetition with its next move
+static bool checkUpcomingRepetition(const std::string& fen, const std::vector<Move>& moves, bool expected, const std::string& description)
+{
+    Searcher searcher = Searcher(false);
+    Board board = Board(fen);
+    searcher.addBoardToHistory(board);
+    for(const Move& move : moves)
+    {
+        board.performMove(move);
+        searcher.addBoardToHistory(board);
+    }
+
+    if(searcher.hasUpcomingRepetition(board) != expected)
+    {
+        FAIL("Expected the upcoming repetition to be " << (expected ? "found" : "rejected") << " when " << description << " in " << board.fen())
+        return false;
+    }
+
+    SUCCESS("The upcoming repetition was " << (expected ? "found" : "rejected") << " when " << description)
+    return true;
+}
+
+// Test the detection of positions where the side to move can repeat an earlier position with a single reversible move
+static bool testUpcomingRepetition()
+{
+    const Move blackKingG8 = Move(Square::H8, Square::G8, MoveInfoBit::KING_MOVE);
+    const Move blackKingH8 = Move(Square::G8, Square::H8, MoveInfoBit::KING_MOVE);
+
+    // The rook walks around from a1 to a3, such that it can return to a1 with a single move
+    // The initial position is repeated once before the walk, so returning to it is a draw at the root
+    const std::vector<Move> moves = {
+        blackKingG8,
+        Move(Square::A1, Square::B1, MoveInfoBit::ROOK_MOVE),
+        blackKingH8,
+        Move(Square::B1, Square::A1, MoveInfoBit::ROOK_MOVE),
+        blackKingG8,
+        Move(Square::A1, Square::B1, MoveInfoBit::ROOK_MOVE),
+        blackKingH8,
+        Move(Square::B1, Square::B3, MoveInfoBit::ROOK_MOVE),
+        blackKingG8,
+        Move(Square::B3, Square::A3, MoveInfoBit::ROOK_MOVE),
+        blackKingH8,
+    };
+
+    // The initial position has only occurred once before, so returning to it is not yet a draw
+    const std::vector<Move> singleOccurrenceMoves = std::vector<Move>(moves.begin() + 4, moves.end());
+
+    // Before the last king move, the rook on a3 could return to a1 to repeat the position with the king on g8 twice, but it is black to move
+    const std::vector<Move> opponentMoves = std::vector<Move>(moves.begin(), moves.end() - 1);
+
+    const std::string openFen    = "7k/8/8/8/8/8/8/R3K3 b - - 0 1";
+    const std::string blockedFen = "7k/8/8/8/8/8/N7/R3K3 b - - 0 1";
+
+    bool passed = true;
+    passed &= checkUpcomingRepetition(openFen, moves, true, "the rook can return to a twice repeated position");
+    passed &= checkUpcomingRepetition(openFen, singleOccurrenceMoves, false, "the rook can only return to a position which occurred once");
+    passed &= checkUpcomingRepetition(blockedFen, moves, false, "the path of the rook back to the repeated position is blocked");
+    passed &= checkUpcomingRepetition(openFen, opponentMoves, false, "only the opponent can move back to the repeated position");
+    return passed;
+}
+
 bool Test::runDrawTest()
 {
     bool passed = true;
 
     passed &= testCheckmateWithoutRepeat();
+    passed &= testUpcomingRepetition();
 
     if(passed)
     {
@@ -0,0 +1,71 @@
+#include <tests/test.hpp>
+#include <search.hpp>
+
+using namespace Arcanum;
+
+struct MatePosition
+{
+    std::string fen;
+    std::string bestMove;
+    uint32_t mateMoves;
+};
+
+// Searches for a mate with the given number of moves, and returns the score
+static eval_t searchMate(Searcher& searcher, const Board& board, uint32_t mateMoves, Move& bestMove)
+{
+    SearchParameters params = SearchParameters();
+    params.mate = mateMoves;
+
+    SearchResult result;
+    bestMove = searcher.search(board, params, &result);
+    return result.eval;
+}
+
+bool Test::runMateTest()
+{
+    const MatePosition positions[] = {
+        {"r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 4 4",    "f3f7", 1},
+        {"6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",                                  "d1d8", 1},
+        {"r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1",      "d5f6", 2},
+        {"r1b1kb1r/pppp1ppp/5q2/4n3/3KP3/2N3PN/PPP4P/R1BQ1B1R b kq - 0 1",         "f8c5", 3},
+    };
+
+    Searcher searcher = Searcher(false);
+    searcher.resizeTT(16);
+    searcher.setNumThreads(2);
+
+    for(const MatePosition& position : positions)
+    {
+        Board board = Board(position.fen);
+        searcher.clear();
+
+        // Fill the TT with a normal search, as the mate search cannot trust all the mates found by it
+        SearchParameters params = SearchParameters();
+        params.useDepth = true;
+        params.depth = 8;
+        searcher.search(board, params);
+
+        Move bestMove;
+        eval_t score = searchMate(searcher, board, position.mateMoves, bestMove);
+        if(!Evaluator::isRealMateScore(score) || Evaluator::getMateDistance(score) != int32_t(position.mateMoves) || bestMove.toString() != position.bestMove)
+        {
+            FAIL("Expected " << position.bestMove << " to mate in " << position.mateMoves << ", found " << bestMove << " with score " << score << " in " << position.fen)
+            return false;
+        }
+
+        // No mate is found with fewer moves
+        if(position.mateMoves > 1)
+        {
+            score = searchMate(searcher, board, position.mateMoves - 1, bestMove);
+            if(Evaluator::isRealMateScore(score))
+            {
+                FAIL("Found a mate in " << Evaluator::getMateDistance(score) << " with " << bestMove << " when the shortest mate is in " << position.mateMoves << " in " << position.fen)
+                return false;
+            }
+        }
+
+        SUCCESS("Found mate in " << position.mateMoves << " with " << position.bestMove << " in " << position.fen)
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include <tests/test.hpp>
+#include <search.hpp>
+#include <sstream>
+#include <set>
+
+using namespace Arcanum;
+
+// Converts the score of an info line to a value which can be compared, where shorter mates are better
+static int64_t parseScore(std::istringstream& is)
+{
+    std::string type;
+    int64_t value;
+    is >> type >> value;
+
+    if(type == "mate")
+    {
+        return value > 0 ? 1000000 - value : -1000000 - value;
+    }
+
+    return value;
+}
+
+// Checks that the lines of each depth are reported with non-increasing scores and different moves
+static bool checkLineOrder(const std::string& output, const std::string& fen)
+{
+    std::istringstream lines(output);
+    std::string line;
+    uint32_t previousDepth = 0;
+    int64_t previousScore = 0;
+    uint32_t numLines = 0;
+    std::set<std::string> depthMoves;
+
+    while(std::getline(lines, line))
+    {
+        std::istringstream is(line);
+        std::string token;
+        uint32_t depth = 0;
+        uint32_t multiPV = 0;
+        int64_t score = 0;
+        std::string move;
+
+        is >> token;
+        if(token != "info")
+        {
+            continue;
+        }
+
+        while(is >> token)
+        {
+            if(token == "depth") is >> depth;
+            else if(token == "multipv") is >> multiPV;
+            else if(token == "score") score = parseScore(is);
+            else if(token == "pv") { is >> move; break; }
+        }
+
+        if(multiPV == 0)
+        {
+            continue;
+        }
+
+        if(multiPV > 1 && depth == previousDepth && score > previousScore)
+        {
+            FAIL("Line " << multiPV << " scored " << score << " which is higher than " << previousScore << " of the previous line at depth " << depth << " in " << fen)
+            return false;
+        }
+
+        if(depth != previousDepth)
+        {
+            depthMoves.clear();
+        }
+
+        if(!depthMoves.insert(move).second)
+        {
+            FAIL("Line " << multiPV << " repeated the move " << move << " of a previous line at depth " << depth << " in " << fen)
+            return false;
+        }
+
+        previousDepth = depth;
+        previousScore = score;
+        numLines++;
+    }
+
+    if(numLines == 0)
+    {
+        FAIL("No lines were reported for " << fen)
+        return false;
+    }
+
+    SUCCESS("The " << numLines << " reported lines were ordered by score in " << fen)
+    return true;
+}
+
+// Returns the UCI output of the search
+static std::string searchAndCaptureOutput(Searcher& searcher, const Board& board, const SearchParameters& params)
+{
+    std::stringstream output;
+    std::streambuf* coutBuffer = std::cout.rdbuf(output.rdbuf());
+    searcher.search(board, params);
+    std::cout.rdbuf(coutBuffer);
+
+    return output.str();
+}
+
+bool Test::runMultiPVTest()
+{
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    };
+
+    Searcher searcher = Searcher(true);
+    searcher.resizeTT(16);
+
+    for(const std::string& fen : fens)
+    {
+        Board board = Board(fen);
+
+        searcher.clear();
+        SearchParameters params = SearchParameters();
+        params.useDepth = true;
+        params.depth = 10;
+        params.multiPV = 4;
+
+        if(!checkLineOrder(searchAndCaptureOutput(searcher, board, params), fen))
+        {
+            return false;
+        }
+
+        // The time limit stops the search part way through the lines of the last iteration
+        searcher.clear();
+        params = SearchParameters();
+        params.useTime = true;
+        params.msTime = 150;
+        params.multiPV = 4;
+
+        if(!checkLineOrder(searchAndCaptureOutput(searcher, board, params), fen))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
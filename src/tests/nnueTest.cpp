@@ -0,0 +1,279 @@
+#include <tests/test.hpp>
+#include <tuning/nnueformat.hpp>
+#include <eval.hpp>
+#include <timer.hpp>
+#include <utils.hpp>
+#include <memory>
+#include <random>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace Arcanum;
+
+// Compares the incremental and batched evals of all positions within the depth with the evals of a fresh accumulator
+static void checkEvals(Board& board, Evaluator& evaluator, uint32_t depth, std::vector<Board>& boards, bool* failed)
+{
+    boards.push_back(board);
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    if((moves.size == 0) || (depth == 0))
+    {
+        return;
+    }
+
+    board.generateCaptureInfo(moves);
+    for(uint8_t i = 0; i < moves.size; i += NNUE::MaxBatchSize)
+    {
+        const Move* batch[NNUE::MaxBatchSize];
+        eval_t batchEvals[NNUE::MaxBatchSize];
+        uint8_t batchSize = std::min(uint8_t(NNUE::MaxBatchSize), uint8_t(moves.size - i));
+        for(uint8_t j = 0; j < batchSize; j++)
+        {
+            batch[j] = &moves[i + j];
+        }
+        evaluator.evaluateMoves(board, batch, batchSize, batchEvals);
+
+        for(uint8_t j = 0; j < batchSize; j++)
+        {
+            Board newBoard = Board(board);
+            newBoard.performMove(*batch[j]);
+            eval_t expected = Evaluator::nnue.predictBoard(newBoard);
+
+            evaluator.pushMoveToAccumulator(board, *batch[j]);
+            eval_t incremental = evaluator.evaluate(newBoard);
+
+            if((incremental != expected) || (batchEvals[j] != expected))
+            {
+                FAIL("Eval mismatch after move: " << *batch[j] << " From board: " << board.fen() << " Expected: " << expected << " Incremental: " << incremental << " Batched: " << batchEvals[j])
+                *failed |= true;
+            }
+
+            if(!*failed)
+            {
+                checkEvals(newBoard, evaluator, depth - 1, boards, failed);
+            }
+            evaluator.popMoveFromAccumulator();
+
+            if(*failed)
+            {
+                return; // Exit early on failure
+            }
+        }
+    }
+}
+
+// Measures the evals per second of NNUE::predict
+// Only a few accumulators are used, as the accumulator is already in the cache when predicting in the search
+static void benchmarkPredict(const std::vector<Board>& boards)
+{
+    constexpr uint32_t NumPositions = 8;
+    constexpr uint32_t NumRounds = 1000000;
+
+    std::unique_ptr<NNUE::Accumulator[]> accumulators(new NNUE::Accumulator[NumPositions]);
+    for(uint32_t i = 0; i < NumPositions; i++)
+    {
+        Evaluator::nnue.initializeAccumulator(&accumulators[i], boards[i]);
+    }
+
+    int64_t checksum = 0;
+    Timer timer;
+    timer.start();
+    for(uint32_t round = 0; round < NumRounds; round++)
+    {
+        for(uint32_t i = 0; i < NumPositions; i++)
+        {
+            checksum += Evaluator::nnue.predict(&accumulators[i], boards[i]);
+        }
+    }
+    int64_t timeNs = timer.getNs();
+
+    uint64_t numEvals = uint64_t(NumPositions) * NumRounds;
+    uint64_t evalsPerSec = (numEvals * 1000000000LL) / std::max(int64_t(1), timeNs);
+    INFO("Predicted " << numEvals << " evals in " << timeNs / 1000000 << " ms, " << evalsPerSec << " Evals / Sec (Checksum: " << checksum << ")")
+}
+
+// Writes a float net with random weights within the quantized range
+static bool writeRandomFloatNet(const std::string& filename)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> ftDistribution(-0.4f, 0.4f);
+    std::uniform_real_distribution<float> l1Distribution(-1.5f, 1.5f);
+
+    std::vector<float> ftWeights(NNUE::L1Size * NNUE::FTSize);
+    std::vector<float> ftBiases(NNUE::L1Size);
+    std::vector<float> l1Weights(NNUE::L1Size);
+    std::vector<float> l1Biases(1);
+    for(float& weight : ftWeights) weight = ftDistribution(generator);
+    for(float& bias : ftBiases)    bias   = ftDistribution(generator);
+
+    NNUEEncoder encoder;
+    if(!encoder.open(filename))
+    {
+        return false;
+    }
+
+    encoder.write(ftWeights.data(), NNUE::L1Size, NNUE::FTSize);
+    encoder.write(ftBiases.data(), NNUE::L1Size, 1);
+    for(uint32_t i = 0; i < NNUE::NumOutputBuckets; i++)
+    {
+        for(float& weight : l1Weights) weight = l1Distribution(generator);
+        l1Biases[0] = l1Distribution(generator);
+        encoder.write(l1Weights.data(), 1, NNUE::L1Size);
+        encoder.write(l1Biases.data(), 1, 1);
+    }
+    encoder.close();
+
+    return true;
+}
+
+// Writes a copy of the quantized net, with the version of the header incremented and the end of the file truncated
+static bool writeModifiedQuantizedNet(const std::string& src, const std::string& dst, uint32_t versionIncrement, size_t numTruncatedBytes)
+{
+    std::ifstream ifs(getWorkPath() + src, std::ios::in | std::ios::binary);
+    std::vector<char> data = std::vector<char>(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    if(data.size() < sizeof(NNUE::QuantizedHeader))
+    {
+        FAIL("Unable to read the quantized net " << src)
+        return false;
+    }
+
+    NNUE::QuantizedHeader header;
+    std::memcpy(&header, data.data(), sizeof(NNUE::QuantizedHeader));
+    header.version += versionIncrement;
+    std::memcpy(data.data(), &header, sizeof(NNUE::QuantizedHeader));
+
+    std::ofstream ofs(getWorkPath() + dst, std::ios::out | std::ios::binary);
+    ofs.write(data.data(), data.size() - numTruncatedBytes);
+    return true;
+}
+
+// Returns true if the net gives the same evals as the expected evals
+static bool matchesEvals(NNUE& nnue, const std::vector<Board>& boards, const std::vector<eval_t>& expected)
+{
+    for(size_t i = 0; i < boards.size(); i++)
+    {
+        if(nnue.predictBoard(boards[i]) != expected[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Quantizes a float net, stores it in the quantized format and checks that the loaded net gives the same evals
+// Quantized nets with a header which does not match the architecture are rejected, and the current net is kept
+static bool testQuantizedFormat(const std::vector<Board>& allBoards)
+{
+    const std::string floatFilename = "nnue-test.fnnue";
+    const std::string quantizedFilename = "nnue-test.qnnue";
+    const std::string badFilename = "nnue-test-bad.qnnue";
+
+    std::vector<Board> boards;
+    for(size_t i = 0; i < allBoards.size(); i += 97)
+    {
+        boards.push_back(allBoards[i]);
+    }
+
+    bool passed = true;
+    NNUE floatNet;
+    NNUE quantizedNet;
+    std::vector<eval_t> expected;
+
+    if(!writeRandomFloatNet(floatFilename) || !floatNet.load(floatFilename) || !floatNet.storeQuantized(quantizedFilename))
+    {
+        FAIL("Failed to quantize and store the float net")
+        passed = false;
+    }
+
+    if(passed)
+    {
+        for(const Board& board : boards)
+        {
+            expected.push_back(floatNet.predictBoard(board));
+        }
+
+        if(!quantizedNet.load(quantizedFilename) || !matchesEvals(quantizedNet, boards, expected))
+        {
+            FAIL("The stored quantized net did not give the evals of the quantized float net")
+            passed = false;
+        }
+    }
+
+    if(passed)
+    {
+        SUCCESS("The stored quantized net gave the evals of the quantized float net for " << boards.size() << " positions")
+
+        // A wrong version and a truncated net are both rejected
+        const std::pair<uint32_t, size_t> badNets[] = {
+            {1, 0}, // Version increment and number of truncated bytes
+            {0, 1},
+        };
+
+        for(const auto& [versionIncrement, numTruncatedBytes] : badNets)
+        {
+            if(!writeModifiedQuantizedNet(quantizedFilename, badFilename, versionIncrement, numTruncatedBytes) || quantizedNet.load(badFilename))
+            {
+                FAIL("The quantized net with the version incremented by " << versionIncrement << " and " << numTruncatedBytes << " bytes truncated was not rejected")
+                passed = false;
+                break;
+            }
+
+            if(!matchesEvals(quantizedNet, boards, expected))
+            {
+                FAIL("The current net was not kept after rejecting the quantized net with the version incremented by " << versionIncrement << " and " << numTruncatedBytes << " bytes truncated")
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if(passed)
+    {
+        SUCCESS("Rejected quantized nets with a wrong version or size, and kept the current net")
+    }
+
+    std::remove((getWorkPath() + floatFilename).c_str());
+    std::remove((getWorkPath() + quantizedFilename).c_str());
+    std::remove((getWorkPath() + badFilename).c_str());
+
+    return passed;
+}
+
+bool Test::runNnueTest()
+{
+    bool failed = false;
+    std::vector<Board> boards;
+    Evaluator evaluator;
+
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppppp2P/8/8/8/2P5/PP1pK1PP/RNBQ1BNR b kq - 1 8",
+        "rnbqkbnr/pppp1ppp/8/8/4PpP1/8/PPPP3P/RNBQKBNR b KQkq g3 0 3",
+    };
+
+    for(const std::string& fen : fens)
+    {
+        Board board = Board(fen);
+        evaluator.initAccumulatorStack(board);
+        checkEvals(board, evaluator, 3, boards, &failed);
+        if(failed)
+        {
+            FAIL("Failed evals from " << fen)
+            return false;
+        }
+    }
+    SUCCESS("Incremental and batched evals matched the evals of " << boards.size() << " positions")
+
+    if(!testQuantizedFormat(boards))
+    {
+        return false;
+    }
+
+    benchmarkPredict(boards);
+
+    return true;
+}
\ No newline at end of file
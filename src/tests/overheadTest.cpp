@@ -0,0 +1,114 @@
+#include <tests/test.hpp>
+#include <uci/overhead.hpp>
+#include <utils.hpp>
+
+using namespace Arcanum;
+using namespace Arcanum::Interface;
+
+static bool checkPercentile(const LatencyEstimator& estimator, float percentile, int64_t expected)
+{
+    int64_t latency = estimator.getPercentile(percentile);
+    if(latency != expected)
+    {
+        FAIL("Expected " << expected << " as the " << percentile << " percentile, got " << latency)
+        return false;
+    }
+
+    return true;
+}
+
+static bool testLatencyEstimator()
+{
+    LatencyEstimator estimator;
+    if(!checkPercentile(estimator, 0.95f, 0))
+    {
+        return false;
+    }
+
+    // Negative latencies are clamped to zero
+    estimator.addSample(-100);
+    if(!checkPercentile(estimator, 0.95f, 0))
+    {
+        return false;
+    }
+
+    // Add the samples 1 to 100 in reverse order, such that the window wraps and keeps the 64 last samples 1 to 64
+    for(int64_t latency = 100; latency > 0; latency--)
+    {
+        estimator.addSample(latency);
+    }
+
+    if(estimator.getNumSamples() != 64)
+    {
+        FAIL("Expected 64 samples in the window, got " << estimator.getNumSamples())
+        return false;
+    }
+
+    if(!checkPercentile(estimator, 0.0f, 1) || !checkPercentile(estimator, 0.5f, 33) || !checkPercentile(estimator, 0.95f, 61) || !checkPercentile(estimator, 1.0f, 64))
+    {
+        return false;
+    }
+
+    // The 10 oldest samples, 64 to 55, are pushed out of the window by the new samples
+    for(int64_t latency = 1000; latency < 1010; latency++)
+    {
+        estimator.addSample(latency);
+    }
+
+    if(!checkPercentile(estimator, 0.0f, 1) || !checkPercentile(estimator, 0.5f, 33) || !checkPercentile(estimator, 0.95f, 1006) || !checkPercentile(estimator, 1.0f, 1009))
+    {
+        return false;
+    }
+
+    SUCCESS("Estimated the latency percentiles over a wrapped window")
+    return true;
+}
+
+static bool testMoveOverheadEstimator()
+{
+    MoveOverheadEstimator estimator;
+    if(estimator.isCalibrated() || estimator.getMsOverhead() != 0)
+    {
+        FAIL("The estimator without samples is calibrated or has an overhead of " << estimator.getMsOverhead() << "ms")
+        return false;
+    }
+
+    // Only the stop latency decides when the estimator is calibrated
+    for(uint32_t i = 0; i < 100; i++)
+    {
+        estimator.addStartupLatency(1500);
+    }
+
+    for(uint32_t i = 0; i < 7; i++)
+    {
+        estimator.addStopLatency(2200);
+    }
+
+    if(estimator.isCalibrated())
+    {
+        FAIL("The estimator is calibrated with only 7 stop latency samples")
+        return false;
+    }
+
+    estimator.addStopLatency(2200);
+    if(!estimator.isCalibrated())
+    {
+        FAIL("The estimator is not calibrated with 8 stop latency samples")
+        return false;
+    }
+
+    // 1500us + 2200us rounds up to 4ms
+    if(estimator.getMsOverhead() != 4)
+    {
+        FAIL("Expected an overhead of 4ms, got " << estimator.getMsOverhead() << "ms")
+        return false;
+    }
+
+    SUCCESS("Calibrated the move overhead estimate")
+    return true;
+}
+
+bool Test::runOverheadTest()
+{
+    return testLatencyEstimator() && testMoveOverheadEstimator();
+}
\ No newline at end of file
@@ -85,7 +85,8 @@ static std::string seeEDPs[] = {
 static bool testPosition(std::string fen, Move move, bool expected)
 {
     Board board = Board(fen, false);
-    board.getLegalMoves();
+    MoveList moves;
+    board.generateLegalMoves(moves); // Generates the pinners and blockers used by see()
     bool seeScore = board.see(move);
 
     if(seeScore != expected)
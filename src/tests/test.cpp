@@ -73,6 +73,10 @@ bool Test::parseArgumentsAndRunTests(int argc, char* argv[])
         {"--zobrist",  Test::runZobristTest},
         {"--capture",  Test::runCaptureTest},
         {"--draw",     Test::runDrawTest},
+        {"--nnue",     Test::runNnueTest},
+        {"--multipv",  Test::runMultiPVTest},
+        {"--mate",     Test::runMateTest},
+        {"--overhead", Test::runOverheadTest},
     };
 
     // Run all tests if no specific test is given
@@ -12,4 +12,8 @@ namespace Arcanum::Test
     bool runZobristTest();
     bool runCaptureTest();
     bool runDrawTest();
+    bool runNnueTest();
+    bool runMultiPVTest();
+    bool runMateTest();
+    bool runOverheadTest();
 }
\ No newline at end of file
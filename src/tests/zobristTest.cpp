@@ -5,15 +5,16 @@ using namespace Arcanum;
 
 static void playAllMovesAndCheckZobrist(Board& board, uint32_t depth, bool* failed)
 {
-    Move* legalMoves = board.getLegalMoves();
-    uint8_t numLegalMoves = board.getNumLegalMoves();
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    uint8_t numLegalMoves = legalMoves.size;
 
     if((numLegalMoves == 0) || (depth == 0))
     {
         return;
     }
 
-    board.generateCaptureInfo();
+    board.generateCaptureInfo(legalMoves);
     for(int i = 0; i < numLegalMoves; i++)
     {
         Board newBoard = Board(board);
@@ -40,6 +41,21 @@ static void playAllMovesAndCheckZobrist(Board& board, uint32_t depth, bool* fail
             *failed |= true;
         }
 
+        // Unmaking the move should restore the position and the hashes
+        Board unmadeBoard = Board(board);
+        UndoRecord undo;
+        unmadeBoard.makeMove(legalMoves[i], undo);
+        unmadeBoard.unmakeMove(legalMoves[i], undo);
+        if((unmadeBoard.getHash() != board.getHash())
+        || (unmadeBoard.getPawnHash() != board.getPawnHash())
+        || (unmadeBoard.getMaterialHash() != board.getMaterialHash())
+        || (unmadeBoard.getHalfMoves() != board.getHalfMoves())
+        || (unmadeBoard.getFullMoves() != board.getFullMoves()))
+        {
+            FAIL("Unmake did not restore the position after move: " << legalMoves[i] << " From board: " << board.fen() << " To board: " << unmadeBoard.fen())
+            *failed |= true;
+        }
+
         if(!*failed)
         {
             playAllMovesAndCheckZobrist(newBoard, depth - 1, failed);
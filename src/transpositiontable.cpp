@@ -7,9 +7,20 @@
 #include <string>
 #include <utils.hpp>
 #include <memory.hpp>
+#include <numa.hpp>
+#include <thread>
+#include <vector>
 
 using namespace Arcanum;
 
+// The stats are shared between all threads using the table,
+// and are only collected when debug logging is enabled.
+#ifndef DISABLE_DEBUG
+#define TT_STAT(_stat) _stat;
+#else
+#define TT_STAT(_stat)
+#endif
+
 TranspositionTable::TranspositionTable() :
     m_table(nullptr),
     m_mbSize(0),
@@ -73,12 +84,46 @@ void TranspositionTable::clear()
     clearStats();
 
     // Set all table enties to be invalid
-    for(size_t i = 0; i < m_numClusters; i++)
+    TTEntry invalidEntry = TTEntry(0, NULL_MOVE, 0, 0, 0, 0, false, TTFlag::EXACT);
+    invalidEntry.invalidate();
+    auto clearClusters = [&](size_t begin, size_t end)
     {
-        for(size_t j = 0; j < NumClusterEntries; j++)
+        for(size_t i = begin; i < end; i++)
         {
-            m_table[i].entries[j].invalidate();
+            for(size_t j = 0; j < NumClusterEntries; j++)
+            {
+                m_storeEntry(&m_table[i].slots[j], invalidEntry);
+            }
         }
+    };
+
+    uint32_t numNodes = Numa::getNumNodes();
+    if(numNodes <= 1)
+    {
+        clearClusters(0, m_numClusters);
+        return;
+    }
+
+    // Interleave the table across the NUMA nodes.
+    // Each chunk of the table is cleared by a thread bound to a node,
+    // which places the pages on that node when they are touched for the first time after allocation.
+    constexpr size_t ChunkSize = (2 * 1024 * 1024) / sizeof(TTCluster);
+    std::vector<std::thread> threads;
+    for(uint32_t node = 0; node < numNodes; node++)
+    {
+        threads.emplace_back([&, node]
+        {
+            Numa::bindThread(node);
+            for(size_t begin = node * ChunkSize; begin < m_numClusters; begin += numNodes * ChunkSize)
+            {
+                clearClusters(begin, std::min(begin + ChunkSize, m_numClusters));
+            }
+        });
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
     }
 }
 
@@ -87,6 +132,25 @@ inline size_t TranspositionTable::m_getClusterIndex(hash_t hash)
     return hash % m_numClusters;
 }
 
+inline TTEntry TranspositionTable::m_loadEntry(const TTSlot* slot)
+{
+    // Each word is loaded atomically, but the pair might be torn by a concurrent store
+    uint64_t data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    uint64_t key  = __atomic_load_n(&slot->key,  __ATOMIC_RELAXED);
+
+    TTEntry entry;
+    std::memcpy(&entry, &data, sizeof(data));
+    entry._hash = key ^ data;
+    return entry;
+}
+
+inline void TranspositionTable::m_storeEntry(TTSlot* slot, const TTEntry& entry)
+{
+    uint64_t data = entry.getData();
+    __atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->key,  entry._hash ^ data, __ATOMIC_RELAXED);
+}
+
 inline eval_t TranspositionTable::m_toTTEval(eval_t eval, uint8_t plyFromRoot)
 {
     if(Evaluator::isMateScore(eval))
@@ -125,14 +189,13 @@ std::optional<TTEntry> TranspositionTable::get(hash_t hash, uint8_t plyFromRoot)
         return {};
     }
 
-    TTCluster* clusterPtr = static_cast<TTCluster*>(__builtin_assume_aligned(m_table + m_getClusterIndex(hash), CACHE_LINE_SIZE));
-    TTCluster cluster = *clusterPtr;
+    TTCluster* cluster = static_cast<TTCluster*>(__builtin_assume_aligned(m_table + m_getClusterIndex(hash), CACHE_LINE_SIZE));
 
-    m_stats.lookups++;
+    TT_STAT(m_stats.lookups++)
 
     for(size_t i = 0; i < NumClusterEntries; i++)
     {
-        TTEntry entry = cluster.entries[i];
+        TTEntry entry = m_loadEntry(&cluster->slots[i]);
 
         if(entry.isValid() && entry.getHash() == (hash & TTEntry::HashMask))
         {
@@ -145,7 +208,7 @@ std::optional<TTEntry> TranspositionTable::get(hash_t hash, uint8_t plyFromRoot)
         }
     }
 
-    m_stats.lookupMisses++;
+    TT_STAT(m_stats.lookupMisses++)
 
     return {}; // Return empty optional
 }
@@ -166,17 +229,23 @@ void TranspositionTable::add(eval_t eval, Move move, bool isPv, uint8_t depth, u
     newEntry.eval    = m_toTTEval(newEntry.eval, plyFromRoot);
     newEntry.rawEval = m_toTTEval(newEntry.rawEval, plyFromRoot);
 
-    m_stats.entriesAdded++;
+    TT_STAT(m_stats.entriesAdded++)
+
+    TTEntry oldEntries[NumClusterEntries];
+    for(size_t i = 0; i < NumClusterEntries; i++)
+    {
+        oldEntries[i] = m_loadEntry(&cluster->slots[i]);
+    }
 
     // Check if the entry is already in the cluster,
     // or if there is an invalid entry where the new entry can be placed
     for(size_t i = 0; i < NumClusterEntries; i++)
     {
-        TTEntry oldEntry = cluster->entries[i];
+        const TTEntry& oldEntry = oldEntries[i];
 
         if(!oldEntry.isValid())
         {
-            cluster->entries[i] = newEntry;
+            m_storeEntry(&cluster->slots[i], newEntry);
             return;
         }
 
@@ -186,12 +255,12 @@ void TranspositionTable::add(eval_t eval, Move move, bool isPv, uint8_t depth, u
         {
             if((oldEntry.depth < newEntry.depth) || (oldEntry.isPv() < newEntry.isPv()))
             {
-                m_stats.updates++;
-                cluster->entries[i] = newEntry;
+                TT_STAT(m_stats.updates++)
+                m_storeEntry(&cluster->slots[i], newEntry);
             }
             else
             {
-                m_stats.blockedUpdates++;
+                TT_STAT(m_stats.blockedUpdates++)
             }
             return;
         }
@@ -199,29 +268,27 @@ void TranspositionTable::add(eval_t eval, Move move, bool isPv, uint8_t depth, u
 
     // Check if the new entry can/should be placed into the cluster
     // Find the entry with the lowest priority, and replace it if the new entry has a higher priority
-    TTEntry *replace = nullptr;
+    TTSlot *replace = nullptr;
     int32_t lowestPriority = newEntry.getPriority(m_generation);
     for(size_t i = 0; i < NumClusterEntries; i++)
     {
-        TTEntry* oldEntry = &cluster->entries[i];
-
-        int32_t priority = oldEntry->getPriority(m_generation);
+        int32_t priority = oldEntries[i].getPriority(m_generation);
         if(priority < lowestPriority)
         {
             lowestPriority = priority;
-            replace = oldEntry;
+            replace = &cluster->slots[i];
         }
     }
 
     // Replace if a suitable replacement is found
     if(replace)
     {
-        *replace = newEntry;
-        m_stats.replacements++;
+        m_storeEntry(replace, newEntry);
+        TT_STAT(m_stats.replacements++)
         return;
     }
 
-    m_stats.blockedReplacements++;
+    TT_STAT(m_stats.blockedReplacements++)
 }
 
 // Note: If the table has been resized to a smaller table, the stats may not be entirely accurate.
@@ -262,6 +329,19 @@ void TranspositionTable::logStats()
 
 uint32_t TranspositionTable::permills()
 {
-    uint64_t entriesInTable = m_stats.entriesAdded - m_stats.replacements - m_stats.blockedReplacements - m_stats.updates - m_stats.blockedUpdates;
-    return m_stats.maxEntries > 0 ? (1000 * entriesInTable / m_stats.maxEntries) : 1000;
+    if(m_numEntries == 0)
+    {
+        return 1000;
+    }
+
+    // Sample the first entries of the table, as the stats are not always collected
+    size_t numSamples = std::min(m_numEntries, size_t(1000));
+    size_t numUsed = 0;
+    for(size_t i = 0; i < numSamples; i++)
+    {
+        TTEntry entry = m_loadEntry(&m_table[i / NumClusterEntries].slots[i % NumClusterEntries]);
+        numUsed += entry.isValid() && (entry.getGeneration() == m_generation);
+    }
+
+    return (1000 * numUsed) / numSamples;
 }
\ No newline at end of file
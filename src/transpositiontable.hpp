@@ -4,6 +4,7 @@
 #include <eval.hpp>
 #include <board.hpp>
 #include <optional>
+#include <cstring>
 
 namespace Arcanum
 {
@@ -22,20 +23,25 @@ namespace Arcanum
         // placed in the same cluster will have the same LSBs of the hash
         // In fact, for the smallest non-zero TT (1MB) the 15 LSBs will match in each cluster:
         // 1024*1024 bytes / 32 bytes per cluster = 32768 clusters. Log2(32768) = 15
-        static constexpr hash_t  HashMask        = 0xFFFFFFFFFFFF8000;
-        static constexpr hash_t  PvMask          = 0b1;
-        static constexpr uint8_t PvOffset        = 0;
-        static constexpr hash_t  TTFlagMask      = 0b110;
-        static constexpr uint8_t TTFlagOffset    = 1;
-        static constexpr uint8_t MaxGeneration   = 0xff;
+        static constexpr hash_t  HashMask         = 0xFFFFFFFFFFFF8000;
+        static constexpr uint8_t PvMask           = 0b1;
+        static constexpr uint8_t PvOffset         = 0;
+        static constexpr uint8_t TTFlagMask       = 0b110;
+        static constexpr uint8_t TTFlagOffset     = 1;
+        static constexpr uint8_t GenerationOffset = 3;
+        static constexpr uint8_t MaxGeneration    = 0x1f;
 
         // Total 16 bytes
+        // Note: The first 8 bytes are the data word which is used to verify the entry in the table
+        // All the fields except the hash are in the data word, such that a torn entry cannot pass as a valid entry
         uint8_t depth;             // 1 byte
-        uint8_t generation;        // 1 byte
+        uint8_t genFlagAndIsPv;    // 1 byte: [5 bits: generation | 2 bits: TT Flag | 1 bit: isPv]
         eval_t eval;               // 2 bytes
         eval_t rawEval;            // 2 bytes
         PackedMove packedMove;     // 2 bytes
-        hash_t _hashNpFlagAndIsPv; // 8 bytes: [49 bits: hash | 12 bits: unused | 2 bits: TT Flag | 1 bit: isPv]
+        hash_t _hash;              // 8 bytes: [49 bits: hash | 15 bits: zero]
+
+        TTEntry() = default;
 
         TTEntry(
             hash_t hash,
@@ -48,14 +54,14 @@ namespace Arcanum
             TTFlag flag
         ) :
             depth(depth),
-            generation(generation),
             eval(eval),
             rawEval(rawEval),
-            packedMove(PackedMove(move))
+            packedMove(PackedMove(move)),
+            _hash(hash & HashMask)
         {
-            _hashNpFlagAndIsPv = (hash & HashMask)
-            | (static_cast<hash_t>(flag) << TTFlagOffset)
-            | (static_cast<hash_t>(isPv) << PvOffset);
+            genFlagAndIsPv = (generation << GenerationOffset)
+            | (static_cast<uint8_t>(flag) << TTFlagOffset)
+            | (static_cast<uint8_t>(isPv) << PvOffset);
         }
 
         // Returns how valuable it is to keep the entry in TT
@@ -68,7 +74,12 @@ namespace Arcanum
         {
             // Find the age of the entry with respect to the current generation
             // This supports warp around for the generation counter
-            return (MaxGeneration + 1 + currentGeneration - generation) & MaxGeneration;
+            return (MaxGeneration + 1 + currentGeneration - getGeneration()) & MaxGeneration;
+        }
+
+        inline uint8_t getGeneration() const
+        {
+            return genFlagAndIsPv >> GenerationOffset;
         }
 
         inline PackedMove getPackedMove() const
@@ -76,19 +87,20 @@ namespace Arcanum
             return packedMove;
         }
 
+        // The hash is not masked, as the bits below the hash are only zero if the entry is not torn
         inline hash_t getHash() const
         {
-            return _hashNpFlagAndIsPv & HashMask;
+            return _hash;
         }
 
         inline TTFlag getTTFlag() const
         {
-            return TTFlag((_hashNpFlagAndIsPv & TTFlagMask) >> TTFlagOffset);
+            return TTFlag((genFlagAndIsPv & TTFlagMask) >> TTFlagOffset);
         }
 
         inline bool isPv() const
         {
-            return (_hashNpFlagAndIsPv & PvMask) >> PvOffset;
+            return (genFlagAndIsPv & PvMask) >> PvOffset;
         }
 
         inline bool isValid() const
@@ -100,8 +112,17 @@ namespace Arcanum
         {
             depth = InvalidDepth;
         }
+
+        inline uint64_t getData() const
+        {
+            uint64_t data;
+            std::memcpy(&data, this, sizeof(data));
+            return data;
+        }
     };
 
+    static_assert(sizeof(TTEntry) == 16, "The size of TTEntry is not correct. Padding might be needed");
+
     struct TTStats
     {
         uint64_t entriesAdded;
@@ -128,12 +149,22 @@ namespace Arcanum
     class TranspositionTable
     {
         private:
+            // Entries are stored as two 64 bit words, where the key is the hash xor'ed with the data.
+            // This allows multiple threads to access the table without locks.
+            // A torn write from another thread results in a mismatching key, and the entry is treated as a miss.
+            // The decoded key is compared as a whole, such that a difference in any bit of the data is detected.
+            struct TTSlot
+            {
+                uint64_t data;
+                uint64_t key;
+            };
+
             // Make each cluster fit into NumClusterBytes bytes
             static constexpr uint32_t NumClusterBytes = 32;
-            static constexpr uint32_t NumClusterEntries = NumClusterBytes / sizeof(TTEntry);
+            static constexpr uint32_t NumClusterEntries = NumClusterBytes / sizeof(TTSlot);
             struct TTCluster
             {
-                TTEntry entries[NumClusterEntries];
+                TTSlot slots[NumClusterEntries];
             };
 
             static_assert(sizeof(TTCluster) == NumClusterBytes, "The size of TTCluster is not correct. Padding might be needed");
@@ -145,6 +176,8 @@ namespace Arcanum
             TTStats m_stats;
             uint8_t m_generation;
             size_t m_getClusterIndex(hash_t hash);
+            TTEntry m_loadEntry(const TTSlot* slot);
+            void m_storeEntry(TTSlot* slot, const TTEntry& entry);
             eval_t m_toTTEval(eval_t eval, uint8_t plyFromRoot);
             eval_t m_fromTTEval(eval_t eval, uint8_t plyFromRoot);
         public:
@@ -442,8 +442,9 @@ void BinpackParser::m_parseNextMoveAndScore()
     #ifdef VERIFY_BINPACK
     {
         // Check if the move is legal in the position
-        Move* moves = m_currentBoard.getLegalMoves();
-        uint8_t numMoves = m_currentBoard.getNumLegalMoves();
+        MoveList moves;
+        m_currentBoard.generateLegalMoves(moves);
+        uint8_t numMoves = moves.size;
         bool found = false;
         for(uint8_t i = 0; i < numMoves; i++)
         {
@@ -10,6 +10,7 @@
 #include <fen.hpp>
 #include <timer.hpp>
 #include <syzygy.hpp>
+#include <numa.hpp>
 
 using namespace Arcanum;
 
@@ -35,6 +36,7 @@ void Fengen::start(FengenParameters params)
 
     searchParams.useTime    = params.movetime > 0;
     searchParams.msTime     = params.movetime;
+    searchParams.msSoftTime = params.softtime;
     searchParams.useDepth   = params.depth > 0;
     searchParams.depth      = params.depth;
     searchParams.useNodes   = params.nodes > 0;
@@ -73,6 +75,9 @@ void Fengen::start(FengenParameters params)
 
     auto fn = [&](uint32_t id)
     {
+        // Bind the thread before allocating the runner, to keep its searchers and TTs on the same NUMA node
+        Numa::bindThread(Numa::getNodeForThread(id));
+
         std::string startfen;
         GameRunner runner;
 
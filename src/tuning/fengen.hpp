@@ -18,6 +18,7 @@ namespace Arcanum
         uint32_t numThreads;      // Number of threads to use
         uint32_t depth;           // Max depth to search to. Unused if 0
         uint32_t movetime;        // Max time to search (ms). Unused if 0
+        uint32_t softtime;        // Soft time limit (ms), scaled by the stability of the search. Unused if 0
         uint32_t nodes;           // Max nodes to search. Unused if 0
         uint32_t ttSize;          // Size of the transposition table in MB.
         eval_t   scoreLimit;      // Maximum absolute score to allow for randomized positions
@@ -32,6 +33,7 @@ namespace Arcanum
         numThreads(0),
         depth(0),
         movetime(0),
+        softtime(0),
         nodes(0),
         ttSize(0),
         scoreLimit(400)
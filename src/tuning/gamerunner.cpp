@@ -175,8 +175,7 @@ bool GameRunner::m_isDrawAdjudicated()
 bool GameRunner::m_isGameCompleted()
 {
     // Check if the position is repeated
-    auto history = m_searchers[0].getHistory();
-    if(history.at(m_board.getHash()) > 2)
+    if(m_searchers[0].getNumOccurrences(m_board) > 2)
     {
         m_result = GameResult::DRAW;
         return true;
@@ -250,8 +249,9 @@ void GameRunner::randomizeInitialPosition(uint32_t plies, const Board& board, ev
 
         for(uint32_t i = 0; i < plies; i++)
         {
-            Move* moves = m_initialBoard.getLegalMoves();
-            uint8_t numMoves = m_initialBoard.getNumLegalMoves();
+            MoveList moves;
+            m_initialBoard.generateLegalMoves(moves);
+            uint8_t numMoves = moves.size;
 
             if(numMoves == 0)
             {
@@ -259,7 +259,7 @@ void GameRunner::randomizeInitialPosition(uint32_t plies, const Board& board, ev
             }
 
             // Select random move and perform it
-            m_initialBoard.generateCaptureInfo();
+            m_initialBoard.generateCaptureInfo(moves);
             std::uniform_int_distribution<uint8_t> dist(0, numMoves - 1);
             Move move = moves[dist(m_generator)];
             m_initialBoard.performMove(move);
@@ -1,33 +1,162 @@
 #include <tuning/nnueformat.hpp>
 #include <utils.hpp>
+#include <memory.hpp>
 #include <fstream>
 
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 using namespace Arcanum;
 
 #ifdef ENABLE_INCBIN
 #define INCBIN_PREFIX
+#define INCBIN_ALIGNMENT_INDEX 6 // Align to 64 bytes, such that a quantized net can be used in place
 #include <incbin/incbin.hpp>
 INCBIN(char, EmbeddedNNUE, TOSTRING(DEFAULT_NNUE));
 #endif
 
+NNUEFile::NNUEFile() :
+    m_data(nullptr),
+    m_size(0),
+    m_storage(Storage::NONE)
+{}
+
+NNUEFile::~NNUEFile()
+{
+    close();
+}
+
+NNUEFile& NNUEFile::operator=(NNUEFile&& other)
+{
+    if(this != &other)
+    {
+        close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_storage = other.m_storage;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_storage = Storage::NONE;
+    }
+
+    return *this;
+}
+
+bool NNUEFile::open(const std::string& filename)
+{
+    close();
+
+    DEBUG("Reading NNUE: " << filename)
+    #ifdef ENABLE_INCBIN
+    if(filename == TOSTRING(DEFAULT_NNUE))
+    {
+        m_data = EmbeddedNNUEData;
+        m_size = EmbeddedNNUESize;
+        m_storage = Storage::EMBEDDED;
+        return true;
+    }
+    #endif
+
+    std::string path = getWorkPath();
+    path += filename;
+
+    #if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        ERROR("Unable to open " << path)
+        return false;
+    }
+
+    struct stat fileStat;
+    if((fstat(fd, &fileStat) != 0) || (fileStat.st_size == 0))
+    {
+        ERROR("Unable to read the size of " << path)
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping is kept after the file descriptor is closed
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+    {
+        ERROR("Unable to map " << path)
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = fileStat.st_size;
+    m_storage = Storage::MAPPED;
+    #else
+    std::ifstream ifs (path, std::ios::in | std::ios::binary);
+    if(!ifs.is_open())
+    {
+        ERROR("Unable to open " << path)
+        return false;
+    }
+
+    // Find the size of the file
+    ifs.seekg(0, std::ios::end);
+    m_size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+
+    // Read the data into memory aligned as a mapped file
+    char* data = static_cast<char*>(Memory::alignedMalloc(m_size, 64));
+    ifs.read(data, m_size);
+    ifs.close();
+
+    m_data = data;
+    m_storage = Storage::ALLOCATED;
+    #endif
+
+    return true;
+}
+
+void NNUEFile::close()
+{
+    switch (m_storage)
+    {
+    case Storage::MAPPED:
+        #if defined(__linux__)
+        munmap(const_cast<char*>(m_data), m_size);
+        #endif
+        break;
+    case Storage::ALLOCATED:
+        Memory::alignedFree(const_cast<char*>(m_data));
+        break;
+    default:
+        break;
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_storage = Storage::NONE;
+}
+
+const char* NNUEFile::data() const
+{
+    return m_data;
+}
+
+size_t NNUEFile::size() const
+{
+    return m_size;
+}
+
 static const char* NNUEMagic = "Arcanum FNNUE v6";
 static const char* NNUEDescription = "768->1024->1 Quantizable";
 
 NNUEParser::NNUEParser() :
     m_data(nullptr),
-    m_dataAllocated(false),
     m_offset(0),
     m_size(0)
 {};
 
-NNUEParser::~NNUEParser()
-{
-    if(m_dataAllocated)
-    {
-        delete[] m_data;
-    }
-}
-
 uint32_t NNUEParser::m_getU32()
 {
     if(m_offset + sizeof(uint32_t) > m_size)
@@ -85,42 +214,14 @@ bool NNUEParser::m_readHeader()
 
 bool NNUEParser::load(const std::string& filename)
 {
-    if(m_dataAllocated)
+    if(!m_file.open(filename))
     {
-        delete[] m_data;
+        return false;
     }
 
-    DEBUG("Reading NNUE: " << filename)
-    #ifdef ENABLE_INCBIN
-    if(filename == TOSTRING(DEFAULT_NNUE))
-    {
-        m_offset = 0;
-        m_dataAllocated = false;
-        m_size = EmbeddedNNUESize;
-        m_data = EmbeddedNNUEData;
-    } else
-    #endif
-    {
-        std::string path = getWorkPath();
-        path += filename;
-        std::ifstream ifs (path, std::ios::in | std::ios::binary);
-        if(!ifs.is_open())
-        {
-            ERROR("Unable to open " << path)
-            return false;
-        }
-        // Find the size of the file
-        ifs.seekg(0, std::ios::end);
-        m_size = ifs.tellg();
-        ifs.seekg(0, std::ios::beg);
-
-        // Read the data
-        m_offset = 0;
-        m_dataAllocated = true;
-        m_data = new char[m_size];
-        ifs.read(const_cast<char*>(m_data), m_size);
-        ifs.close();
-    }
+    m_offset = 0;
+    m_size = m_file.size();
+    m_data = m_file.data();
 
     return m_readHeader();
 }
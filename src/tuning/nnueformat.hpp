@@ -2,23 +2,74 @@
 
 #include <string>
 #include <cmath>
+#include <limits>
 #include <utils.hpp>
 
 namespace Arcanum
 {
+    // Read-only view of a net file
+    // The file is memory mapped when possible, such that processes loading the same net share the page cache
+    // If the filename is the default net, the net embedded in the executable is used
+    class NNUEFile
+    {
+        private:
+            enum class Storage : uint8_t
+            {
+                NONE,
+                EMBEDDED,
+                MAPPED,
+                ALLOCATED,
+            };
+
+            const char* m_data;
+            size_t m_size;
+            Storage m_storage;
+        public:
+            NNUEFile();
+            ~NNUEFile();
+            NNUEFile(const NNUEFile&) = delete;
+            NNUEFile& operator=(const NNUEFile&) = delete;
+            NNUEFile& operator=(NNUEFile&& other);
+            bool open(const std::string& filename);
+            void close();
+            const char* data() const;
+            size_t size() const;
+    };
+
     class NNUEParser
     {
         private:
+            NNUEFile m_file;
             const char* m_data;
-            bool m_dataAllocated;
             uint32_t m_offset;
             uint32_t m_size;
 
             uint32_t m_getU32();
             bool m_readHeader();
+
+            // Quantizes the value to the type T
+            // Returns false if the quantized value is outside the range of T
+            template <typename T>
+            static bool m_quantize(float value, int32_t qFactor, T& dst)
+            {
+                if constexpr (std::is_same<T, float>::value)
+                {
+                    dst = qFactor * value;
+                }
+                else
+                {
+                    float quantized = std::round(qFactor * value);
+                    if(quantized < float(std::numeric_limits<T>::min()) || quantized > float(std::numeric_limits<T>::max()))
+                    {
+                        return false;
+                    }
+                    dst = static_cast<T>(quantized);
+                }
+
+                return true;
+            }
         public:
             NNUEParser();
-            ~NNUEParser();
             bool load(const std::string& filename);
 
             // Reads the values of a matrix as floats, and quantizes it to the type T
@@ -34,16 +85,16 @@ namespace Arcanum
                 }
 
                 const float* data = reinterpret_cast<const float*>(m_data + m_offset);
+                uint32_t numOutOfRange = 0;
                 for(uint32_t i = 0; i < rows * cols; i++)
                 {
-                    if constexpr (std::is_same<T, float>::value)
-                    {
-                        dst[i] = qFactor * data[i];
-                    }
-                    else
-                    {
-                        dst[i] = static_cast<T>(std::round(qFactor * data[i]));
-                    }
+                    numOutOfRange += !m_quantize(data[i], qFactor, dst[i]);
+                }
+
+                if(numOutOfRange > 0)
+                {
+                    ERROR(numOutOfRange << " of " << rows * cols << " values at offset " << m_offset << " are outside the quantized range when multiplied by " << qFactor)
+                    return false;
                 }
 
                 m_offset += bytes;
@@ -64,22 +115,22 @@ namespace Arcanum
                 }
 
                 const float* data = reinterpret_cast<const float*>(m_data + m_offset);
+                uint32_t numOutOfRange = 0;
                 for(uint32_t i = 0; i < rows; i++)
                 {
                     for(uint32_t j = 0; j < cols; j++)
                     {
                         // Write in row-major order and read in column-major
-                        if constexpr (std::is_same<T, float>::value)
-                        {
-                            dst[i * cols + j] = qFactor * data[j*rows + i];
-                        }
-                        else
-                        {
-                            dst[i * cols + j] = static_cast<T>(std::round(qFactor * data[j*rows + i]));
-                        }
+                        numOutOfRange += !m_quantize(data[j*rows + i], qFactor, dst[i * cols + j]);
                     }
                 }
 
+                if(numOutOfRange > 0)
+                {
+                    ERROR(numOutOfRange << " of " << rows * cols << " values at offset " << m_offset << " are outside the quantized range when multiplied by " << qFactor)
+                    return false;
+                }
+
                 m_offset += bytes;
                 return true;
             }
@@ -4,6 +4,7 @@
 #include <utils.hpp>
 #include <fen.hpp>
 #include <math.h>
+#include <limits>
 #include <eval.hpp>
 #include <timer.hpp>
 
@@ -231,6 +232,10 @@ void NNUETrainer::m_applyGradient(uint32_t timestep)
     {
         m_net.l1Weights[i].clamp(-127.0f/NNUE::LQ, 127.0f/NNUE::LQ);
     }
+
+    // Clamp the featuretransformer weights to the range of the quantized weight type
+    constexpr float FTWeightLimit = float(std::numeric_limits<NNUE::ftweight_t>::max()) / NNUE::FTQ;
+    m_net.ftWeights.clamp(-FTWeightLimit, FTWeightLimit);
 }
 
 // Returns true if the position should be skipped / filtered out
@@ -256,8 +261,7 @@ bool NNUETrainer::m_shouldFilterPosition(Board& board, Move& move, eval_t eval)
     }
 
     // Filter positions with only one legal move
-    board.getLegalMoves();
-    if(board.getNumLegalMoves() == 1)
+    if(board.countLegalMoves() == 1)
     {
         return true;
     }
@@ -330,10 +334,10 @@ std::tuple<float, float> NNUETrainer::m_getValidationLoss(const std::string& fil
     return std::tuple<float, float>(totalLoss / m_params.validationSize, totalQLoss / m_params.validationSize);
 }
 
-std::string NNUETrainer::m_getOutputFilename(const std::string& base, uint32_t epoch)
+std::string NNUETrainer::m_getOutputFilename(const std::string& base, uint32_t epoch, const std::string& extension)
 {
     std::stringstream ss;
-    ss << base << epoch << ".fnnue";
+    ss << base << epoch << extension;
     return ss.str();
 }
 
@@ -477,14 +481,24 @@ void NNUETrainer::train(TrainingParameters params)
         }
         INFO("Epoch time: " << epochTimer.getMs() << " ms")
 
-        // Get the filename for the current epoch
-        std::string netFilename = m_getOutputFilename(m_params.output, epoch);
+        // Get the filenames for the current epoch
+        std::string netFilename = m_getOutputFilename(m_params.output, epoch, ".fnnue");
+        std::string quantizedNetFilename = m_getOutputFilename(m_params.output, epoch, ".qnnue");
 
         // Store the net for each epoch
+        // The float net is used to continue training, and the quantized net is used by the engine
         store(netFilename);
+        {
+            NNUE quantizedNet;
+            if(quantizedNet.load(netFilename))
+            {
+                quantizedNet.storeQuantized(quantizedNetFilename);
+            }
+        }
 
         // Calculate validation loss
-        auto [validationLoss, validationQLoss] = m_getValidationLoss(netFilename);
+        // The quantized loss is calculated with the exported quantized net
+        auto [validationLoss, validationQLoss] = m_getValidationLoss(quantizedNetFilename);
         INFO("Validation loss: " << validationLoss)
         INFO("Validation loss (Quantized): " << validationQLoss)
 
@@ -69,7 +69,7 @@ namespace Arcanum
 
             static float m_sigmoid(float v);
             static float m_sigmoidPrime(float sigmoid);
-            static std::string m_getOutputFilename(const std::string& base, uint32_t epoch);
+            static std::string m_getOutputFilename(const std::string& base, uint32_t epoch, const std::string& extension);
             static void m_logLoss(float epochLoss, uint64_t epochPosCount, float validationLoss, float validationQLoss, const std::string& prefix, const std::string& filename);
 
             float m_predict(const Board& board);
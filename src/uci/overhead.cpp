@@ -0,0 +1,59 @@
+#include <uci/overhead.hpp>
+#include <algorithm>
+
+using namespace Arcanum;
+using namespace Arcanum::Interface;
+
+LatencyEstimator::LatencyEstimator() :
+    m_numSamples(0),
+    m_index(0)
+{
+    m_samples.fill(0);
+}
+
+void LatencyEstimator::addSample(int64_t usLatency)
+{
+    m_samples[m_index] = std::max(usLatency, int64_t(0));
+    m_index = (m_index + 1) % NumSamples;
+    m_numSamples = std::min(m_numSamples + 1, NumSamples);
+}
+
+int64_t LatencyEstimator::getPercentile(float percentile) const
+{
+    if(m_numSamples == 0)
+    {
+        return 0;
+    }
+
+    std::array<int64_t, NumSamples> samples = m_samples;
+    size_t index = std::min(size_t(percentile * m_numSamples), m_numSamples - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.begin() + m_numSamples);
+    return samples[index];
+}
+
+size_t LatencyEstimator::getNumSamples() const
+{
+    return m_numSamples;
+}
+
+void MoveOverheadEstimator::addStartupLatency(int64_t usLatency)
+{
+    m_startupLatency.addSample(usLatency);
+}
+
+void MoveOverheadEstimator::addStopLatency(int64_t usLatency)
+{
+    m_stopLatency.addSample(usLatency);
+}
+
+int64_t MoveOverheadEstimator::getMsOverhead() const
+{
+    int64_t usOverhead = m_startupLatency.getPercentile(Percentile) + m_stopLatency.getPercentile(Percentile);
+    return (usOverhead + 999) / 1000;
+}
+
+// Searches are only stopped by time in timed games, so the stop latency is sampled less often than the startup latency
+bool MoveOverheadEstimator::isCalibrated() const
+{
+    return m_stopLatency.getNumSamples() >= MinSamples;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <types.hpp>
+#include <array>
+#include <cstddef>
+
+namespace Arcanum
+{
+    namespace Interface
+    {
+        // Keeps a rolling window of latency samples, and estimates a high percentile of the latency
+        class LatencyEstimator
+        {
+            private:
+                static constexpr size_t NumSamples = 64;
+                std::array<int64_t, NumSamples> m_samples;
+                size_t m_numSamples;
+                size_t m_index;
+            public:
+                LatencyEstimator();
+                void addSample(int64_t usLatency);
+                int64_t getPercentile(float percentile) const; // Returns 0 if there are no samples
+                size_t getNumSamples() const;
+        };
+
+        // Estimates the move overhead from the measured latencies of the engine.
+        // The startup latency is the time from receiving 'go' until the search starts.
+        // The stop latency is the time from the search stopping due to time until the best move is sent.
+        class MoveOverheadEstimator
+        {
+            private:
+                static constexpr float Percentile = 0.95f;
+                static constexpr size_t MinSamples = 8; // Number of stop latency samples required before the estimate is used
+                LatencyEstimator m_startupLatency;
+                LatencyEstimator m_stopLatency;
+            public:
+                void addStartupLatency(int64_t usLatency);
+                void addStopLatency(int64_t usLatency);
+                int64_t getMsOverhead() const; // Returns the estimated overhead, rounded up to the nearest ms
+                bool isCalibrated() const;
+        };
+    }
+}
@@ -7,10 +7,17 @@ namespace Arcanum
 {
     namespace Interface
     {
-        int64_t getAllocatedTime(int64_t time, int64_t inc, int64_t movesToGo, int64_t moveTime, int64_t moveOverhead)
+        struct TimeAllocation
+        {
+            int64_t msSoftTime; // Time to use in a normal search. It is scaled by the stability of the search
+            int64_t msHardTime; // Time which the search cannot exceed
+        };
+
+        TimeAllocation getAllocatedTime(int64_t time, int64_t inc, int64_t movesToGo, int64_t moveTime, int64_t moveOverhead)
         {
             constexpr int64_t T1 = 30;
             constexpr int64_t T2 = 2;
+            constexpr int64_t T3 = 4;
 
             // Add some margin to the time limit
             // In actuality, the search will likely use a bit more time than allocated
@@ -18,27 +25,33 @@ namespace Arcanum
             // Thus, we have to ensure it does not surpass the remaining time minus the moveOverhead.
             int64_t timeLimit = time - moveOverhead;
             int64_t allocatedTime = 0LL;
+            int64_t maxTime = 0LL;
 
             if(movesToGo > 0)
             {
                 // Note: This can exceed the time limit,
                 //       but it is resolved at the bottom
                 allocatedTime = (timeLimit / movesToGo) + inc;
+                maxTime = timeLimit;
             }
             else
             {
-                allocatedTime = std::min((timeLimit / T1) + inc, timeLimit / T2);
+                allocatedTime = (timeLimit / T1) + inc;
+                maxTime = timeLimit / T2;
             }
 
             // If a movetime is specified, it is also an upper bound on the allocated time
             // This has to be done after time allocation, because we want the allocation to depend on the remaining time.
             // Note that moveOverhead is already subtracted from moveTime.
             if(moveTime > 0)
-                timeLimit = std::min(timeLimit, moveTime);
+                maxTime = std::min(maxTime, moveTime);
 
-            // Ensure that the allocated time does not surpass the time limit
+            // The hard limit allows the search to use more time than allocated when the search is unstable
             // Note: timeLimit can be negative, due to subtracting the moveOverhead. Thus, a lower bound of 1ms is used.
-            return std::max(std::min(timeLimit, allocatedTime), int64_t(1));
+            TimeAllocation allocation;
+            allocation.msHardTime = std::max(std::min(maxTime, T3 * allocatedTime), int64_t(1));
+            allocation.msSoftTime = std::max(std::min(allocation.msHardTime, allocatedTime), int64_t(1));
+            return allocation;
         }
     }
-}
\ No newline at end of file
+}
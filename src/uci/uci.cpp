@@ -4,6 +4,7 @@
 #include <tuning/nnuetrainer.hpp>
 #include <uci/wdlmodel.hpp>
 #include <syzygy.hpp>
+#include <numa.hpp>
 #include <fen.hpp>
 #include <perft.hpp>
 #include <utils.hpp>
@@ -11,19 +12,33 @@
 using namespace Arcanum;
 using namespace Arcanum::Interface;
 
-bool        UCI::isSearching = false;
-std::thread UCI::searchThread;
 Board       UCI::board(FEN::startpos);
 Searcher    UCI::searcher;
+
+std::atomic<bool>       UCI::isSearching(false);
+std::thread             UCI::searchThread;
+std::mutex              UCI::searchMutex;
+std::condition_variable UCI::searchCondition;
+bool                    UCI::searchRequested = false;
+bool                    UCI::exitSearchThread = false;
+Board                   UCI::searchBoard(FEN::startpos);
+SearchParameters        UCI::searchParameters;
+Timer                   UCI::commandTimer;
+Timer                   UCI::searchRequestTimer;
+MoveOverheadEstimator   UCI::overheadEstimator;
 std::vector<Option*> Option::options;
 
 SpinOption   UCI::optionHash         = SpinOption("Hash", 32, 0, 2048, []{ UCI::searcher.resizeTT(UCI::optionHash.value); });
+SpinOption   UCI::optionThreads      = SpinOption("Threads", 1, 1, 256, []{ UCI::searcher.setNumThreads(UCI::optionThreads.value); });
+SpinOption   UCI::optionMultiPV      = SpinOption("MultiPV", 1, 1, MaxMoveCount);
 ButtonOption UCI::optionClearHash    = ButtonOption("ClearHash", []{ UCI::searcher.clear(); });
 StringOption UCI::optionSyzygyPath   = StringOption("SyzygyPath", "<empty>", []{ Syzygy::TBInit(UCI::optionSyzygyPath.value); });
 StringOption UCI::optionNNUEPath     = StringOption("NNUEPath", TOSTRING(DEFAULT_NNUE), []{ Evaluator::nnue.load(UCI::optionNNUEPath.value); });
 SpinOption   UCI::optionMoveOverhead = SpinOption("MoveOverhead", 10, 0, 5000);
+CheckOption  UCI::optionAutoMoveOverhead = CheckOption("AutoMoveOverhead", false);
 CheckOption  UCI::optionNormalizeScore = CheckOption("NormalizeScore", true);
 CheckOption  UCI::optionShowWDL      = CheckOption("UCI_ShowWDL", false);
+CheckOption  UCI::optionPonder       = CheckOption("Ponder", false);
 
 void UCI::listUCI()
 {
@@ -118,8 +133,8 @@ void UCI::go(std::istringstream& is)
         else if(token == "movestogo" ) { is >> movesToGo;            }
         else if(token == "perft"     ) { is >> perftDepth;           }
         else if(token == "infinite"  ) { parameters.infinite = true; }
-        else if(token == "ponder"    ) { WARNING("Missing implementation: ponder")  }
-        else if(token == "mate"      ) { WARNING("Missing implementation: mate")    }
+        else if(token == "ponder"    ) { parameters.ponder = true;   }
+        else if(token == "mate"      ) { is >> parameters.mate;      }
         else ERROR("Unknown command: " << token)
     }
 
@@ -131,27 +146,110 @@ void UCI::go(std::istringstream& is)
     }
 
     // Subtract moveOverhead from moveTime
-    if(parameters.msTime != 0) parameters.msTime = std::max(parameters.msTime - optionMoveOverhead.value, int64_t(1));
+    int64_t moveOverhead = getMoveOverhead();
+    if(parameters.msTime != 0) parameters.msTime = std::max(parameters.msTime - moveOverhead, int64_t(1));
+
+    parameters.multiPV = optionMultiPV.value;
 
     // Allocate time
     Color turn = board.getTurn();
     if(requireTimeAlloc[turn])
     {
+        TimeAllocation allocation = getAllocatedTime(time[turn], inc[turn], movesToGo, parameters.msTime, moveOverhead);
         parameters.useTime = true;
-        parameters.msTime = getAllocatedTime(time[turn], inc[turn], movesToGo, parameters.msTime, optionMoveOverhead.value);
+        parameters.msTime = allocation.msHardTime;
+        parameters.msSoftTime = allocation.msSoftTime;
     }
 
-    if(!UCI::isSearching)
     {
-        // Set isSearching before creating the thread.
+        std::lock_guard<std::mutex> lock(searchMutex);
+
+        if(UCI::isSearching)
+        {
+            return;
+        }
+
+        // Set isSearching before waking the worker.
         // This is to make sure it is set before returning from go.
         UCI::isSearching = true;
-        UCI::searchThread = std::thread([&](SearchParameters _parameters) {
-            UCI::searcher.search(board, _parameters);
-            // Set isSearching to false when the search is done in the thread
-            UCI::isSearching = false;
-        }, parameters);
+        UCI::searchRequested = true;
+        UCI::searcher.clearStop();
+        UCI::searchBoard = UCI::board;
+        UCI::searchParameters = parameters;
+        UCI::searchRequestTimer = UCI::commandTimer;
+    }
+
+    searchCondition.notify_all();
+}
+
+// Returns the move overhead to use for the next search.
+// The estimated overhead is used when AutoMoveOverhead is enabled,
+// and enough latency samples have been collected.
+int64_t UCI::getMoveOverhead()
+{
+    std::lock_guard<std::mutex> lock(searchMutex);
+
+    if(optionAutoMoveOverhead.value && overheadEstimator.isCalibrated())
+    {
+        return std::max(overheadEstimator.getMsOverhead(), int64_t(1));
+    }
+
+    return optionMoveOverhead.value;
+}
+
+void UCI::searchWorker()
+{
+    Numa::bindThread(Numa::getNodeForThread(0));
+
+    std::unique_lock<std::mutex> lock(searchMutex);
+    while(true)
+    {
+        searchCondition.wait(lock, []{ return searchRequested || exitSearchThread; });
+
+        if(exitSearchThread)
+        {
+            break;
+        }
+
+        searchRequested = false;
+        Board board = searchBoard;
+        SearchParameters parameters = searchParameters;
+        overheadEstimator.addStartupLatency(searchRequestTimer.getNs() / 1000);
+
+        lock.unlock();
+        SearchResult result;
+        UCI::searcher.search(board, parameters, &result);
+        lock.lock();
+
+        if(result.usStopLatency >= 0)
+        {
+            overheadEstimator.addStopLatency(result.usStopLatency);
+            DEBUG("Estimated move overhead: " << overheadEstimator.getMsOverhead() << " ms")
+        }
+
+        // The best move is reported by the searcher
+        UCI::isSearching = false;
+        searchCondition.notify_all();
+    }
+}
+
+void UCI::startSearchWorker()
+{
+    exitSearchThread = false;
+    searchThread = std::thread(searchWorker);
+}
+
+void UCI::stopSearchWorker()
+{
+    UCI::stop();
+
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        exitSearchThread = true;
     }
+
+    searchCondition.notify_all();
+    searchThread.join();
 }
 
 void UCI::position(std::istringstream& is)
@@ -201,14 +299,32 @@ void UCI::isready()
 
 void UCI::stop()
 {
-    UCI::searcher.stop();
+    std::unique_lock<std::mutex> lock(searchMutex);
+
+    // The stop flag is only cleared by go, such that a stop received before the worker has started the search is not lost
+    if(UCI::isSearching)
+    {
+        UCI::searcher.stop();
+    }
+
+    searchCondition.wait(lock, []{ return !UCI::isSearching; });
+}
+
+void UCI::ponderhit()
+{
+    std::lock_guard<std::mutex> lock(searchMutex);
+
+    if(UCI::isSearching)
+    {
+        UCI::searcher.ponderhit();
+    }
 }
 
 void UCI::eval()
 {
     Evaluator evaluator;
     evaluator.initAccumulatorStack(board);
-    eval_t score = evaluator.evaluate(board, 0);
+    eval_t score = board.hasLegalMove() ? evaluator.evaluate(board) : Evaluator::getTerminalScore(board.isChecked(), 0);
 
     if(optionNormalizeScore.value)
     {
@@ -244,8 +360,11 @@ void UCI::help()
     UCI_OUT("\t[nodes <nodes>]                     - Maximum number of nodes to search")
     UCI_OUT("\t[movetime <movetime>]               - Maximum time to search (ms)")
     UCI_OUT("\t[infinite]                          - Search until stop command is given")
+    UCI_OUT("\t[ponder]                            - Search without time limits until ponderhit or stop is given")
+    UCI_OUT("\t[mate <moves>]                      - Search only for a mate in the given number of moves")
     UCI_OUT("go perft <depth>                      - Run perft to given depth")
     UCI_OUT("stop                                  - Stop any currently ongoing search")
+    UCI_OUT("ponderhit                             - The expected move was played, continue the search with time limits")
     UCI_OUT("position                              - Set the current position")
     UCI_OUT("\tfen <FEN> | startpos                - Set to given FEN or the starting position")
     UCI_OUT("\t[moves <list of moves>]             - Perform the moves after setting the position")
@@ -259,6 +378,7 @@ void UCI::loop()
 {
     UCI::searcher.resizeTT(optionHash.value);
     UCI::newgame();
+    UCI::startSearchWorker();
 
     DEBUG("Entering UCI loop")
     std::string token, cmd;
@@ -267,9 +387,7 @@ void UCI::loop()
         if(!getline(std::cin, cmd))
             cmd = "quit";
 
-        // Join the search thread if the search has finished
-        if(!isSearching && searchThread.joinable())
-            searchThread.join();
+        UCI::commandTimer.start();
 
         DEBUG("UCI command: " << cmd)
 
@@ -284,11 +402,13 @@ void UCI::loop()
         else if (token == "ucinewgame") UCI::newgame();
         else if (token == "isready"   ) UCI::isready();
         else if (token == "stop"      ) UCI::stop();
+        else if (token == "ponderhit" ) UCI::ponderhit();
         else if (token == "eval"      ) UCI::eval();
         else if (token == "d"         ) UCI::drawboard();
         else if (token == "help"      ) UCI::help();
     } while (token != "quit");
 
+    UCI::stopSearchWorker();
     Syzygy::TBFree();
     DEBUG("Exiting UCI loop")
 }
@@ -300,6 +420,12 @@ void UCI::sendInfo(const SearchInfo& info)
     ss << "info";
     ss << " depth " << info.depth;
     ss << " seldepth " << info.seldepth;
+
+    if(info.multiPV > 0)
+    {
+        ss << " multipv " << info.multiPV;
+    }
+
     ss << " time " << info.msTime;
     ss << " nodes " << info.nodes;
     ss << " hashfull " << info.hashfull;
@@ -342,12 +468,24 @@ void UCI::sendInfo(const SearchInfo& info)
     UCI_OUT(ss.str())
 }
 
-void UCI::sendBestMove(const Move& move)
+void UCI::sendCurrMove(const Move& move, uint32_t moveNumber, uint32_t depth)
+{
+    UCI_OUT("info depth " << depth << " currmove " << move << " currmovenumber " << moveNumber)
+}
+
+void UCI::sendBestMove(const Move& move, const Move& ponderMove)
 {
     if(move.isNull())
         ERROR("Illegal Null-Move was reported as the best move")
 
-    UCI_OUT("bestmove " << move)
+    if(ponderMove.isNull())
+    {
+        UCI_OUT("bestmove " << move)
+    }
+    else
+    {
+        UCI_OUT("bestmove " << move << " ponder " << ponderMove)
+    }
 }
 
 // Generate a Move object from a UCI move string (e.g. e2e4, e7e8q)
@@ -3,7 +3,12 @@
 #include <pvtable.hpp>
 #include <search.hpp>
 #include <uci/option.hpp>
+#include <uci/overhead.hpp>
+#include <timer.hpp>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #ifndef ARCANUM_VERSION
 #define ARCANUM_VERSION dev_build
@@ -17,6 +22,7 @@ namespace Arcanum
         {
             uint32_t depth;                      // Current depth in iterative deepening
             uint32_t seldepth;                   // Maximum plys from root in current depth interation
+            uint32_t multiPV;                    // Index of the reported line, starting at 1. Not reported if 0
             uint64_t msTime;                     // Time searched
             uint64_t nsTime;                     // Time searched (nano-seconds)
             uint64_t nodes;                      // Number of nodes searched
@@ -31,6 +37,7 @@ namespace Arcanum
             SearchInfo() :
                 depth(0),
                 seldepth(0),
+                multiPV(0),
                 msTime(0),
                 nodes(0),
                 score(0),
@@ -45,11 +52,30 @@ namespace Arcanum
         class UCI
         {
             private:
-                static bool isSearching;
-                static std::thread searchThread;
                 static Board       board;
                 static Searcher    searcher;
 
+                // The search is performed by a long-lived worker thread,
+                // which waits for new search requests from 'go'
+                static std::atomic<bool>       isSearching;
+                static std::thread             searchThread;
+                static std::mutex              searchMutex;
+                static std::condition_variable searchCondition;
+                static bool                    searchRequested;
+                static bool                    exitSearchThread;
+                static Board                   searchBoard;
+                static SearchParameters        searchParameters;
+
+                // Measures the latency of the engine, used to estimate the move overhead
+                static Timer                   commandTimer; // Started when a command is received
+                static Timer                   searchRequestTimer; // Started when 'go' is received
+                static MoveOverheadEstimator   overheadEstimator;
+                static int64_t getMoveOverhead();
+
+                static void searchWorker();
+                static void startSearchWorker();
+                static void stopSearchWorker();
+
                 static void newgame();
                 static void listUCI();
                 static void setoption(std::istringstream& is);
@@ -57,6 +83,7 @@ namespace Arcanum
                 static void position(std::istringstream& is);
                 static void isready();
                 static void stop();
+                static void ponderhit();
                 static void eval();
                 static void drawboard();
                 static void help();
@@ -64,15 +91,20 @@ namespace Arcanum
             public:
                 // Options
                 static SpinOption   optionHash;
+                static SpinOption   optionThreads;
+                static SpinOption   optionMultiPV;
                 static ButtonOption optionClearHash;
                 static StringOption optionSyzygyPath;
                 static StringOption optionNNUEPath;
                 static SpinOption   optionMoveOverhead;
+                static CheckOption  optionAutoMoveOverhead;
                 static CheckOption  optionNormalizeScore;
                 static CheckOption  optionShowWDL;
+                static CheckOption  optionPonder;
 
-                static void sendBestMove(const Move& move);
+                static void sendBestMove(const Move& move, const Move& ponderMove = NULL_MOVE);
                 static void sendInfo(const SearchInfo& info);
+                static void sendCurrMove(const Move& move, uint32_t moveNumber, uint32_t depth);
                 static void loop();
         };
     }
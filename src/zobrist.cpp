@@ -10,6 +10,8 @@ hash_t Zobrist::m_tables[6][2][64];
 hash_t Zobrist::m_enPassantTable[65]; // Only 16 is actually used, index 64 is used to not read out of bounds
 hash_t Zobrist::m_castleRights[16];
 hash_t Zobrist::m_blackToMove;
+hash_t Zobrist::m_cuckooKeys[Zobrist::CuckooSize];
+Move Zobrist::m_cuckooMoves[Zobrist::CuckooSize];
 
 void Zobrist::init()
 {
@@ -40,6 +42,78 @@ void Zobrist::init()
     m_castleRights[0] = 0LL;
 
     m_blackToMove = distribution(generator);
+
+    m_initCuckooTables();
+}
+
+// Inserts the hash difference of every non-pawn move on an empty board into the cuckoo tables
+// Each key has two possible slots, and an occupying key is kicked to its other slot until an empty slot is found
+void Zobrist::m_initCuckooTables()
+{
+    constexpr uint32_t MoveInfo[6] = { MoveInfoBit::PAWN_MOVE, MoveInfoBit::ROOK_MOVE, MoveInfoBit::KNIGHT_MOVE, MoveInfoBit::BISHOP_MOVE, MoveInfoBit::QUEEN_MOVE, MoveInfoBit::KING_MOVE };
+
+    std::fill(m_cuckooKeys, m_cuckooKeys + CuckooSize, 0LL);
+    std::fill(m_cuckooMoves, m_cuckooMoves + CuckooSize, NULL_MOVE);
+
+    uint32_t numMoves = 0;
+    for(uint8_t piece = Piece::ROOK; piece <= Piece::KING; piece++)
+    {
+        for(uint8_t color = 0; color < 2; color++)
+        {
+            for(square_t from = 0; from < 64; from++)
+            {
+                bitboard_t attacks;
+                switch (piece)
+                {
+                case Piece::ROOK:   attacks = getRookMoves(0LL, from);   break;
+                case Piece::KNIGHT: attacks = getKnightMoves(from);      break;
+                case Piece::BISHOP: attacks = getBishopMoves(0LL, from); break;
+                case Piece::QUEEN:  attacks = getQueenMoves(0LL, from);  break;
+                default:            attacks = getKingMoves(from);
+                }
+
+                while(attacks)
+                {
+                    // Only insert each move in one direction, the key is the same for the reverse move
+                    square_t to = popLS1B(&attacks);
+                    if(to < from)
+                        continue;
+
+                    Move move = Move(from, to, MoveInfo[piece]);
+                    hash_t key = m_tables[piece][color][from] ^ m_tables[piece][color][to] ^ m_blackToMove;
+                    uint32_t index = m_cuckooIndex1(key);
+                    while(true)
+                    {
+                        std::swap(m_cuckooKeys[index], key);
+                        std::swap(m_cuckooMoves[index], move);
+                        if(move.isNull())
+                            break;
+
+                        index = (index == m_cuckooIndex1(key)) ? m_cuckooIndex2(key) : m_cuckooIndex1(key);
+                    }
+                    numMoves++;
+                }
+            }
+        }
+    }
+
+    ASSERT_OR_EXIT(numMoves == 3668, "Unexpected number of reversible moves in cuckoo tables: " << numMoves)
+}
+
+// Returns true if the hash difference between two positions is a single reversible move
+// The move is returned without color, as the same key is used for the move in both directions
+bool Zobrist::getCuckooMove(hash_t moveKey, Move& move)
+{
+    uint32_t index = m_cuckooIndex1(moveKey);
+    if(m_cuckooKeys[index] != moveKey)
+    {
+        index = m_cuckooIndex2(moveKey);
+        if(m_cuckooKeys[index] != moveKey)
+            return false;
+    }
+
+    move = m_cuckooMoves[index];
+    return true;
 }
 
 inline void Zobrist::m_addAllPieces(hash_t &hash, hash_t &materialHash, bitboard_t bitboard, uint8_t pieceType, Color pieceColor)
@@ -13,11 +13,22 @@ namespace Arcanum
             static hash_t m_castleRights[16];
             static hash_t m_blackToMove;
 
+            // Cuckoo tables of the hash difference of every reversible move, used to detect upcoming repetitions
+            // https://web.archive.org/web/20201107002606/https://marcelk.net/2013-04-06/paper/upcoming-rep-v2.pdf
+            static constexpr uint32_t CuckooSize = 8192;
+            static hash_t m_cuckooKeys[CuckooSize];
+            static Move m_cuckooMoves[CuckooSize];
+
+            static inline uint32_t m_cuckooIndex1(hash_t key) { return key & (CuckooSize - 1); }
+            static inline uint32_t m_cuckooIndex2(hash_t key) { return (key >> 16) & (CuckooSize - 1); }
+            static void m_initCuckooTables();
+
             static void m_addAllPieces(hash_t &hash, hash_t &materialHash, bitboard_t bitboard, uint8_t pieceType, Color pieceColor);
         public:
             static void init();
             static void getHashes(const Board &board, hash_t &hash, hash_t &pawnHash, hash_t &materialHash);
             static void getUpdatedHashes(const Board &board, Move move, square_t oldEnPassantSquare, square_t newEnPassantSquare, uint8_t oldCastleRights, uint8_t newCastleRights, hash_t &hash, hash_t &pawnHash, hash_t &materialHash);
             static void updateHashesAfterNullMove(hash_t& hash, hash_t& pawnHash, square_t oldEnPassantSquare);
+            static bool getCuckooMove(hash_t moveKey, Move& move);
     };
 }
\ No newline at end of file